@@ -0,0 +1,450 @@
+#pragma once
+// Host stub of the Pebble SDK header.
+// Only the API surface GridSpace uses is declared here; the implementation in
+// pebble_host.c renders into a software framebuffer so the watchface can be
+// compiled and run on Linux/macOS by scripts/render.sh.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "message_keys.auto.h"
+
+// Platform selection (scripts/render.sh passes -DPBL_PLATFORM_<NAME> etc.)
+typedef enum {
+  PlatformTypeAplite,
+  PlatformTypeBasalt,
+  PlatformTypeChalk,
+  PlatformTypeDiorite,
+  PlatformTypeEmery,
+  PlatformTypeFlint,
+  PlatformTypeGabbro,
+} PlatformType;
+
+#if defined(PBL_PLATFORM_APLITE)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeAplite
+#elif defined(PBL_PLATFORM_BASALT)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeBasalt
+#elif defined(PBL_PLATFORM_CHALK)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeChalk
+#elif defined(PBL_PLATFORM_DIORITE)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeDiorite
+#elif defined(PBL_PLATFORM_EMERY)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeEmery
+#elif defined(PBL_PLATFORM_FLINT)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeFlint
+#elif defined(PBL_PLATFORM_GABBRO)
+  #define PBL_PLATFORM_TYPE_CURRENT PlatformTypeGabbro
+#else
+  #error "No PBL_PLATFORM_* defined"
+#endif
+
+#if defined(PBL_PLATFORM_CHALK)
+  #define PBL_DISPLAY_WIDTH 180
+  #define PBL_DISPLAY_HEIGHT 180
+#elif defined(PBL_PLATFORM_EMERY)
+  #define PBL_DISPLAY_WIDTH 200
+  #define PBL_DISPLAY_HEIGHT 228
+#elif defined(PBL_PLATFORM_GABBRO)
+  #define PBL_DISPLAY_WIDTH 260
+  #define PBL_DISPLAY_HEIGHT 260
+#else
+  #define PBL_DISPLAY_WIDTH 144
+  #define PBL_DISPLAY_HEIGHT 168
+#endif
+
+// PBL_API_EXISTS(name) is true for the platform-specific APIs this stub has
+#define PBL_API_EXISTS(name) PBL_HOST_API_##name
+#ifndef PBL_PLATFORM_APLITE
+  #define PBL_HOST_API_layer_get_unobstructed_bounds 1
+  #define PBL_HOST_API_unobstructed_area_service_subscribe 1
+#endif
+
+#ifdef PBL_ROUND
+  #define PBL_IF_ROUND_ELSE(if_true, if_false) (if_true)
+  #define PBL_IF_RECT_ELSE(if_true, if_false) (if_false)
+#else
+  #define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+  #define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+#endif
+#ifdef PBL_COLOR
+  #define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+  #define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+  #define COLOR_FALLBACK(color, bw) (color)
+#else
+  #define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+  #define PBL_IF_BW_ELSE(if_true, if_false) (if_true)
+  #define COLOR_FALLBACK(color, bw) (bw)
+#endif
+
+// Logging
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number,
+             const char *fmt, ...) __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+// Time (virtual clock driven by the harness)
+time_t pebble_host_time(time_t *tloc);
+#define time(tloc) pebble_host_time(tloc)
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+time_t time_start_of_today(void);
+
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+// Memory (app allocations are routed through the stub so heap use is tracked)
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+void *pebble_host_malloc(size_t size);
+void *pebble_host_calloc(size_t count, size_t size);
+void *pebble_host_realloc(void *ptr, size_t size);
+void pebble_host_free(void *ptr);
+#ifndef PEBBLE_HOST_IMPL
+  #define malloc(size) pebble_host_malloc(size)
+  #define calloc(count, size) pebble_host_calloc(count, size)
+  #define realloc(ptr, size) pebble_host_realloc(ptr, size)
+  #define free(ptr) pebble_host_free(ptr)
+#endif
+
+// Geometry
+typedef struct GPoint {
+  int16_t x;
+  int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+
+typedef struct GSize {
+  int16_t w;
+  int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+
+typedef struct GRect {
+  GPoint origin;
+  GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b);
+bool grect_is_empty(const GRect *const rect);
+bool gpoint_equal(const GPoint *const point_a, const GPoint *const point_b);
+
+typedef enum {
+  GCornerNone = 0,
+  GCornerTopLeft = 1 << 0,
+  GCornerTopRight = 1 << 1,
+  GCornerBottomLeft = 1 << 2,
+  GCornerBottomRight = 1 << 3,
+  GCornersAll = 0xf,
+} GCornerMask;
+
+// Color
+typedef union GColor8 {
+  uint8_t argb;
+  struct {
+    uint8_t b:2;
+    uint8_t g:2;
+    uint8_t r:2;
+    uint8_t a:2;
+  };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorARGB8FromRGBA(r, g, b, a) \
+  ((uint8_t)(((a) >> 6) << 6 | ((r) >> 6) << 4 | ((g) >> 6) << 2 | ((b) >> 6)))
+#define GColorARGB8FromHEX(v) \
+  GColorARGB8FromRGBA(((v) >> 16) & 0xff, ((v) >> 8) & 0xff, (v) & 0xff, 0xff)
+#define GColorFromRGBA(r, g, b, a) ((GColor8){.argb = GColorARGB8FromRGBA(r, g, b, a)})
+#define GColorFromRGB(r, g, b) GColorFromRGBA(r, g, b, 0xff)
+#define GColorFromHEX(v) ((GColor8){.argb = GColorARGB8FromHEX(v)})
+
+#define GColorClearARGB8 ((uint8_t)0x00)
+#define GColorBlackARGB8 ((uint8_t)0xc0)
+#define GColorWhiteARGB8 ((uint8_t)0xff)
+#define GColorLightGrayARGB8 ((uint8_t)0xea)
+#define GColorDarkGrayARGB8 ((uint8_t)0xd5)
+#define GColorRedARGB8 ((uint8_t)0xf0)
+#define GColorGreenARGB8 ((uint8_t)0xcc)
+#define GColorBlueARGB8 ((uint8_t)0xc3)
+
+#define GColorClear ((GColor8){.argb = GColorClearARGB8})
+#define GColorBlack ((GColor8){.argb = GColorBlackARGB8})
+#define GColorWhite ((GColor8){.argb = GColorWhiteARGB8})
+#define GColorLightGray ((GColor8){.argb = GColorLightGrayARGB8})
+#define GColorDarkGray ((GColor8){.argb = GColorDarkGrayARGB8})
+#define GColorRed ((GColor8){.argb = GColorRedARGB8})
+#define GColorGreen ((GColor8){.argb = GColorGreenARGB8})
+#define GColorBlue ((GColor8){.argb = GColorBlueARGB8})
+
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+// Bitmaps
+typedef enum GBitmapFormat {
+  GBitmapFormat1Bit = 0,
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+  GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+
+typedef struct GBitmapDataRowInfo {
+  uint8_t *data;
+  int16_t min_x;
+  int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format,
+                                           GColor *palette, bool free_on_destroy);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds);
+GColor *gbitmap_get_palette(const GBitmap *bitmap);
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+// Graphics context
+typedef struct GContext GContext;
+
+typedef enum {
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet,
+} GCompOp;
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+bool graphics_frame_buffer_is_captured(GContext *ctx);
+
+// Layers
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void layer_destroy(Layer *layer);
+void *layer_get_data(const Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_bounds(Layer *layer, GRect bounds);
+GRect layer_get_bounds(const Layer *layer);
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+GRect layer_get_unobstructed_bounds(const Layer *layer);
+#endif
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+// Windows
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window *window);
+typedef struct WindowHandlers {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor background_color);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+
+// Timers
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+// Battery
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+// Unobstructed area (Quick View covering the bottom of the screen)
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+typedef int32_t AnimationProgress;
+#define ANIMATION_NORMALIZED_MAX 65535
+typedef void (*UnobstructedAreaWillChangeHandler)(GRect final_unobstructed_screen_area, void *context);
+typedef void (*UnobstructedAreaChangeHandler)(AnimationProgress progress, void *context);
+typedef void (*UnobstructedAreaDidChangeHandler)(void *context);
+typedef struct {
+  UnobstructedAreaWillChangeHandler will_change;
+  UnobstructedAreaChangeHandler change;
+  UnobstructedAreaDidChangeHandler did_change;
+} UnobstructedAreaHandlers;
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context);
+void unobstructed_area_service_unsubscribe(void);
+#endif
+
+// Accelerometer taps (wrist flicks)
+typedef enum {
+  ACCEL_AXIS_X = 0,
+  ACCEL_AXIS_Y = 1,
+  ACCEL_AXIS_Z = 2,
+} AccelAxisType;
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+// Health
+typedef enum {
+  HealthEventSignificantUpdate = 0,
+  HealthEventMovementUpdate,
+  HealthEventSleepUpdate,
+  HealthEventMetricAlert,
+  HealthEventHeartRateUpdate,
+} HealthEventType;
+
+typedef enum {
+  HealthMetricStepCount,
+  HealthMetricActiveSeconds,
+  HealthMetricWalkedDistanceMeters,
+} HealthMetric;
+
+typedef int32_t HealthValue;
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+HealthValue health_service_sum_today(HealthMetric metric);
+
+typedef struct {
+  uint8_t steps;
+  uint8_t orientation;
+  uint16_t vmc;
+  bool is_invalid: 1;
+  uint8_t light: 3;
+  uint8_t padding: 4;
+  uint8_t heart_rate_bpm;
+  uint8_t reserved[6];
+} HealthMinuteData;
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+                                           time_t *time_start, time_t *time_end);
+
+// App lifecycle
+void app_event_loop(void);
+
+// Persistent storage
+#define PERSIST_DATA_MAX_LENGTH 256
+#define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
+typedef enum {
+  S_SUCCESS = 0,
+  E_ERROR = -1,
+  E_DOES_NOT_EXIST = -9,
+} StatusCode;
+typedef int32_t status_t;
+
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+bool persist_read_bool(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+status_t persist_write_bool(const uint32_t key, const bool value);
+status_t persist_write_int(const uint32_t key, const int32_t value);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+status_t persist_delete(const uint32_t key);
+
+// Dictionaries and AppMessage
+typedef enum {
+  TUPLE_BYTE_ARRAY = 0,
+  TUPLE_CSTRING = 1,
+  TUPLE_UINT = 2,
+  TUPLE_INT = 3,
+} TupleType;
+
+typedef struct __attribute__((__packed__)) {
+  uint32_t key;
+  TupleType type:8;
+  uint16_t length;
+  union {
+    uint8_t data[0];
+    char cstring[0];
+    uint8_t uint8;
+    uint16_t uint16;
+    uint32_t uint32;
+    int8_t int8;
+    int16_t int16;
+    int32_t int32;
+  } value[];
+} Tuple;
+
+typedef struct {
+  const uint8_t *dictionary;
+  const uint8_t *end;
+  Tuple *cursor;
+} DictionaryIterator;
+
+typedef enum {
+  DICT_OK = 0,
+  DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+  DICT_INVALID_ARGS = 1 << 2,
+} DictionaryResult;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *const buffer, const uint16_t size);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *const cstring);
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *const data, const uint16_t size);
+uint32_t dict_write_end(DictionaryIterator *iter);
+
+typedef enum {
+  APP_MSG_OK = 0,
+  APP_MSG_SEND_TIMEOUT = 1 << 1,
+  APP_MSG_BUSY = 1 << 10,
+} AppMessageResult;
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
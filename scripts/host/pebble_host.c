@@ -0,0 +1,1141 @@
+// Host implementation of the Pebble SDK stub.
+// Renders into a software framebuffer laid out like the real one: 8-bit ARGB
+// rows on color platforms (per-row visible spans on round displays) and
+// LSB-first 1-bit rows padded to 32 bits on aplite/diorite/flint.
+#define PEBBLE_HOST_IMPL
+#include "pebble_host.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#ifdef PBL_ROUND
+  #define FRAME_BUFFER_FORMAT GBitmapFormat8BitCircular
+#elif defined(PBL_COLOR)
+  #define FRAME_BUFFER_FORMAT GBitmapFormat8Bit
+#else
+  #define FRAME_BUFFER_FORMAT GBitmapFormat1Bit
+#endif
+
+#if defined(PBL_PLATFORM_APLITE)
+  #define HEAP_SIZE (24 * 1024)
+#elif defined(PBL_PLATFORM_EMERY) || defined(PBL_PLATFORM_GABBRO)
+  #define HEAP_SIZE (128 * 1024)
+#else
+  #define HEAP_SIZE (64 * 1024)
+#endif
+
+HostStats host_stats;
+
+// ---------------------------------------------------------------------------
+// Logging, memory
+// ---------------------------------------------------------------------------
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number,
+             const char *fmt, ...) {
+  if (!getenv("GRIDSPACE_LOG")) return;
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%s:%d] ", src_filename, src_line_number);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+static size_t s_heap_used;
+
+typedef union {
+  size_t size;
+  max_align_t align;
+} HeapHeader;
+
+void *pebble_host_malloc(size_t size) {
+  if (s_heap_used + size > HEAP_SIZE) return NULL;
+  HeapHeader *header = malloc(sizeof(HeapHeader) + size);
+  if (!header) return NULL;
+  header->size = size;
+  s_heap_used += size;
+  if (s_heap_used > host_stats.heap_peak) host_stats.heap_peak = s_heap_used;
+  return header + 1;
+}
+
+void *pebble_host_calloc(size_t count, size_t size) {
+  void *ptr = pebble_host_malloc(count * size);
+  if (ptr) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void pebble_host_free(void *ptr) {
+  if (!ptr) return;
+  HeapHeader *header = (HeapHeader *)ptr - 1;
+  s_heap_used -= header->size;
+  free(header);
+}
+
+void *pebble_host_realloc(void *ptr, size_t size) {
+  if (!ptr) return pebble_host_malloc(size);
+  HeapHeader *header = (HeapHeader *)ptr - 1;
+  void *copy = pebble_host_malloc(size);
+  if (!copy) return NULL;
+  memcpy(copy, ptr, header->size < size ? header->size : size);
+  pebble_host_free(ptr);
+  return copy;
+}
+
+size_t heap_bytes_used(void) {
+  return s_heap_used;
+}
+
+size_t heap_bytes_free(void) {
+  return HEAP_SIZE - s_heap_used;
+}
+
+size_t host_heap_size(void) {
+  return HEAP_SIZE;
+}
+
+// ---------------------------------------------------------------------------
+// Geometry, color
+// ---------------------------------------------------------------------------
+
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b) {
+  return rect_a->origin.x == rect_b->origin.x && rect_a->origin.y == rect_b->origin.y &&
+         rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+bool grect_is_empty(const GRect *const rect) {
+  return rect->size.w == 0 && rect->size.h == 0;
+}
+
+bool gpoint_equal(const GPoint *const point_a, const GPoint *const point_b) {
+  return point_a->x == point_b->x && point_a->y == point_b->y;
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+  return x.argb == y.argb || (x.a == 0 && y.a == 0);
+}
+
+static GRect prv_intersect(GRect a, GRect b) {
+  int x0 = a.origin.x > b.origin.x ? a.origin.x : b.origin.x;
+  int y0 = a.origin.y > b.origin.y ? a.origin.y : b.origin.y;
+  int ax1 = a.origin.x + a.size.w, bx1 = b.origin.x + b.size.w;
+  int ay1 = a.origin.y + a.size.h, by1 = b.origin.y + b.size.h;
+  int x1 = ax1 < bx1 ? ax1 : bx1;
+  int y1 = ay1 < by1 ? ay1 : by1;
+  if (x1 <= x0 || y1 <= y0) return GRectZero;
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// 1-bit displays threshold on luminance (light gray and brighter read as white)
+static bool prv_color_is_white(GColor8 color) {
+  return color.r + color.g + color.b >= 5;
+}
+
+// ---------------------------------------------------------------------------
+// Bitmaps
+// ---------------------------------------------------------------------------
+
+struct GBitmap {
+  uint8_t *addr;
+  uint16_t row_size_bytes;
+  GBitmapFormat format;
+  GRect bounds;
+  GColor *palette;
+  bool owns_data;
+  bool owns_palette;
+};
+
+static uint16_t prv_row_size(GBitmapFormat format, int16_t width) {
+  switch (format) {
+    case GBitmapFormat1Bit: return ((width + 31) / 32) * 4;
+    case GBitmapFormat1BitPalette: return (width + 7) / 8;
+    case GBitmapFormat2BitPalette: return (width + 3) / 4;
+    case GBitmapFormat4BitPalette: return (width + 1) / 2;
+    default: return width;
+  }
+}
+
+static int prv_palette_size(GBitmapFormat format) {
+  switch (format) {
+    case GBitmapFormat1BitPalette: return 2;
+    case GBitmapFormat2BitPalette: return 4;
+    case GBitmapFormat4BitPalette: return 16;
+    default: return 0;
+  }
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = pebble_host_calloc(1, sizeof(GBitmap));
+  if (!bitmap) return NULL;
+  bitmap->format = format;
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->row_size_bytes = prv_row_size(format, size.w);
+  bitmap->addr = pebble_host_calloc(1, (size_t)bitmap->row_size_bytes * size.h);
+  bitmap->owns_data = true;
+  if (!bitmap->addr) {
+    pebble_host_free(bitmap);
+    return NULL;
+  }
+  int palette_size = prv_palette_size(format);
+  if (palette_size) {
+    bitmap->palette = pebble_host_calloc(palette_size, sizeof(GColor));
+    bitmap->owns_palette = true;
+  }
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format,
+                                           GColor *palette, bool free_on_destroy) {
+  GBitmap *bitmap = gbitmap_create_blank(size, format);
+  if (bitmap) gbitmap_set_palette(bitmap, palette, free_on_destroy);
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect) {
+  GBitmap *bitmap = pebble_host_calloc(1, sizeof(GBitmap));
+  if (!bitmap) return NULL;
+  *bitmap = *base_bitmap;
+  bitmap->owns_data = false;
+  bitmap->owns_palette = false;
+  sub_rect.origin.x += base_bitmap->bounds.origin.x;
+  sub_rect.origin.y += base_bitmap->bounds.origin.y;
+  bitmap->bounds = prv_intersect(sub_rect, base_bitmap->bounds);
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (!bitmap) return;
+  if (bitmap->owns_data) pebble_host_free(bitmap->addr);
+  if (bitmap->owns_palette) pebble_host_free(bitmap->palette);
+  pebble_host_free(bitmap);
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->addr;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->row_size_bytes;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds) {
+  bitmap->bounds = bounds;
+}
+
+GColor *gbitmap_get_palette(const GBitmap *bitmap) {
+  return bitmap->palette;
+}
+
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy) {
+  if (bitmap->owns_palette) pebble_host_free(bitmap->palette);
+  bitmap->palette = palette;
+  bitmap->owns_palette = free_on_destroy;
+}
+
+// Visible pixel span of a row; the full row except on round displays
+static void prv_row_span(const GBitmap *bitmap, int y, int16_t *min_x, int16_t *max_x) {
+  int width = bitmap->bounds.size.w;
+  if (bitmap->format != GBitmapFormat8BitCircular) {
+    *min_x = 0;
+    *max_x = width - 1;
+    return;
+  }
+  double radius = width / 2.0;
+  double dy = y + 0.5 - radius;
+  double half = sqrt(radius * radius - dy * dy);
+  if (!(half > 0.0)) half = 0.0;
+  *min_x = (int16_t)floor(radius - half + 0.5);
+  *max_x = (int16_t)(width - 1 - *min_x);
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  GBitmapDataRowInfo info;
+  info.data = bitmap->addr + (size_t)y * bitmap->row_size_bytes;
+  prv_row_span(bitmap, y, &info.min_x, &info.max_x);
+  return info;
+}
+
+// Read one pixel as a color (absolute data coordinates)
+static GColor8 prv_get_pixel(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = bitmap->addr + (size_t)y * bitmap->row_size_bytes;
+  switch (bitmap->format) {
+    case GBitmapFormat1Bit:
+      return ((row[x / 8] >> (x % 8)) & 1) ? GColorWhite : GColorBlack;
+    case GBitmapFormat1BitPalette:
+      return bitmap->palette[(row[x / 8] >> (7 - x % 8)) & 1];
+    case GBitmapFormat2BitPalette:
+      return bitmap->palette[(row[x / 4] >> (6 - 2 * (x % 4))) & 3];
+    case GBitmapFormat4BitPalette:
+      return bitmap->palette[(row[x / 2] >> (4 - 4 * (x % 2))) & 15];
+    default:
+      return (GColor8){.argb = row[x]};
+  }
+}
+
+// Write one pixel (absolute data coordinates) of the framebuffer formats
+static void prv_set_pixel(GBitmap *bitmap, int x, int y, GColor8 color) {
+  uint8_t *row = bitmap->addr + (size_t)y * bitmap->row_size_bytes;
+  if (bitmap->format == GBitmapFormat1Bit) {
+    if (prv_color_is_white(color)) {
+      row[x / 8] |= (uint8_t)(1 << (x % 8));
+    } else {
+      row[x / 8] &= (uint8_t)~(1 << (x % 8));
+    }
+  } else {
+    row[x] = color.argb;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Graphics context
+// ---------------------------------------------------------------------------
+
+struct GContext {
+  GBitmap *frame_buffer;
+  GPoint origin;  // Absolute position of the current layer's bounds origin
+  GRect clip;     // Absolute clip rect of the current layer
+  GColor fill_color;
+  GColor stroke_color;
+  GCompOp compositing_mode;
+  bool captured;
+};
+
+static GBitmap *s_frame_buffer;
+static GContext s_ctx;
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  host_stats.fill_color_changes++;
+  ctx->fill_color = color;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+  ctx->stroke_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+  ctx->compositing_mode = mode;
+}
+
+void graphics_context_set_antialiased(GContext *ctx, bool enable) {
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  host_stats.fill_rects++;
+  if (ctx->captured || ctx->fill_color.a == 0) return;
+  rect.origin.x += ctx->origin.x;
+  rect.origin.y += ctx->origin.y;
+  GRect area = prv_intersect(rect, ctx->clip);
+  for (int y = area.origin.y; y < area.origin.y + area.size.h; y++) {
+    int16_t min_x, max_x;
+    prv_row_span(ctx->frame_buffer, y, &min_x, &max_x);
+    for (int x = area.origin.x; x < area.origin.x + area.size.w; x++) {
+      if (x < min_x || x > max_x) continue;
+      prv_set_pixel(ctx->frame_buffer, x, y, ctx->fill_color);
+    }
+  }
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  host_stats.bitmap_draws++;
+  if (ctx->captured || !bitmap) return;
+  GRect src = bitmap->bounds;
+  if (src.size.w <= 0 || src.size.h <= 0) return;
+  rect.origin.x += ctx->origin.x;
+  rect.origin.y += ctx->origin.y;
+  GRect area = prv_intersect(rect, ctx->clip);
+  bool has_alpha = bitmap->format != GBitmapFormat1Bit;
+  for (int y = area.origin.y; y < area.origin.y + area.size.h; y++) {
+    int16_t min_x, max_x;
+    prv_row_span(ctx->frame_buffer, y, &min_x, &max_x);
+    int sy = src.origin.y + (y - rect.origin.y) % src.size.h;
+    for (int x = area.origin.x; x < area.origin.x + area.size.w; x++) {
+      if (x < min_x || x > max_x) continue;
+      int sx = src.origin.x + (x - rect.origin.x) % src.size.w;
+      GColor8 color = prv_get_pixel(bitmap, sx, sy);
+      switch (ctx->compositing_mode) {
+        case GCompOpSet:
+          // Transparent pixels (or black 1-bit pixels) keep the destination
+          if (has_alpha ? color.a == 0 : !prv_color_is_white(color)) continue;
+          break;
+        case GCompOpOr:
+          if (!prv_color_is_white(color)) continue;
+          break;
+        case GCompOpAnd:
+          if (prv_color_is_white(color)) continue;
+          break;
+        case GCompOpClear:
+          if (!prv_color_is_white(color)) continue;
+          color = GColorBlack;
+          break;
+        case GCompOpAssignInverted:
+          color.argb = (uint8_t)(~color.argb | 0xc0);
+          break;
+        default:
+          break;
+      }
+      prv_set_pixel(ctx->frame_buffer, x, y, color);
+    }
+  }
+}
+
+static bool s_capture_disabled;
+
+void host_set_frame_buffer_capture(bool enabled) {
+  s_capture_disabled = !enabled;
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  if (ctx->captured || s_capture_disabled) return NULL;
+  host_stats.frame_buffer_captures++;
+  ctx->captured = true;
+  return ctx->frame_buffer;
+}
+
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format) {
+  if (format != ctx->frame_buffer->format) return NULL;
+  return graphics_capture_frame_buffer(ctx);
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  if (!ctx->captured || buffer != ctx->frame_buffer) return false;
+  ctx->captured = false;
+  return true;
+}
+
+bool graphics_frame_buffer_is_captured(GContext *ctx) {
+  return ctx->captured;
+}
+
+// ---------------------------------------------------------------------------
+// Layers and windows
+// ---------------------------------------------------------------------------
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  LayerUpdateProc update_proc;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+  Window *window;
+  bool hidden;
+  uint8_t data[];
+};
+
+struct Window {
+  Layer *root_layer;
+  WindowHandlers handlers;
+  GColor background_color;
+  bool loaded;
+};
+
+static Window *s_top_window;
+static bool s_window_dirty;
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  Layer *layer = pebble_host_calloc(1, sizeof(Layer) + data_size);
+  if (!layer) return NULL;
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+  return layer;
+}
+
+Layer *layer_create(GRect frame) {
+  return layer_create_with_data(frame, 0);
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) return;
+  layer_remove_from_parent(layer);
+  pebble_host_free(layer);
+}
+
+void *layer_get_data(const Layer *layer) {
+  return (void *)layer->data;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  s_window_dirty = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  s_window_dirty = true;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_bounds(Layer *layer, GRect bounds) {
+  layer->bounds = bounds;
+  s_window_dirty = true;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+
+// Bottom edge of the unobstructed screen area
+static int16_t s_unobstructed_bottom = PBL_DISPLAY_HEIGHT;
+
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+  int top = layer->bounds.origin.y;
+  for (const Layer *l = layer; l; l = l->parent) top += l->frame.origin.y;
+  GRect bounds = layer->bounds;
+  int visible = s_unobstructed_bottom - top;
+  if (visible < bounds.size.h) bounds.size.h = (int16_t)(visible > 0 ? visible : 0);
+  return bounds;
+}
+#endif
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  child->parent = parent;
+  child->next_sibling = NULL;
+  Layer **link = &parent->first_child;
+  while (*link) link = &(*link)->next_sibling;
+  *link = child;
+  s_window_dirty = true;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  if (!child->parent) return;
+  Layer **link = &child->parent->first_child;
+  while (*link && *link != child) link = &(*link)->next_sibling;
+  if (*link) *link = child->next_sibling;
+  child->parent = NULL;
+  child->next_sibling = NULL;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) s_window_dirty = true;
+  layer->hidden = hidden;
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+Window *window_create(void) {
+  Window *window = pebble_host_calloc(1, sizeof(Window));
+  if (!window) return NULL;
+  window->root_layer = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+  window->background_color = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) return;
+  if (window->loaded) {
+    if (window->handlers.disappear) window->handlers.disappear(window);
+    if (window->handlers.unload) window->handlers.unload(window);
+  }
+  if (s_top_window == window) s_top_window = NULL;
+  layer_destroy(window->root_layer);
+  pebble_host_free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+  s_window_dirty = true;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return window->root_layer;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (!window->loaded) {
+    window->loaded = true;
+    if (window->handlers.load) window->handlers.load(window);
+  }
+  if (window->handlers.appear) window->handlers.appear(window);
+  s_window_dirty = true;
+}
+
+static void prv_render_layer(Layer *layer, GPoint parent_origin, GRect parent_clip) {
+  if (layer->hidden) return;
+  GRect frame = layer->frame;
+  frame.origin.x += parent_origin.x;
+  frame.origin.y += parent_origin.y;
+  GRect clip = prv_intersect(frame, parent_clip);
+  GPoint origin = GPoint(frame.origin.x + layer->bounds.origin.x,
+                         frame.origin.y + layer->bounds.origin.y);
+  if (layer->update_proc) {
+    s_ctx.origin = origin;
+    s_ctx.clip = clip;
+    s_ctx.fill_color = GColorBlack;
+    s_ctx.stroke_color = GColorBlack;
+    s_ctx.compositing_mode = GCompOpAssign;
+    layer->update_proc(layer, &s_ctx);
+    if (s_ctx.captured) {
+      fprintf(stderr, "warning: layer update proc returned with the frame buffer captured\n");
+      s_ctx.captured = false;
+    }
+  }
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    prv_render_layer(child, origin, clip);
+  }
+}
+
+void host_render(bool force) {
+  if (!s_top_window || (!force && !s_window_dirty)) return;
+  s_window_dirty = false;
+  host_stats.renders++;
+  s_ctx.frame_buffer = s_frame_buffer;
+  s_ctx.captured = false;
+  GRect screen = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+  if (s_top_window->background_color.a != 0) {
+    s_ctx.origin = GPointZero;
+    s_ctx.clip = screen;
+    s_ctx.fill_color = s_top_window->background_color;
+    uint32_t fill_rects = host_stats.fill_rects;
+    graphics_fill_rect(&s_ctx, screen, 0, GCornerNone);
+    host_stats.fill_rects = fill_rects;
+  }
+  prv_render_layer(s_top_window->root_layer, GPointZero, screen);
+}
+
+const GBitmap *host_frame_buffer(void) {
+  return s_frame_buffer;
+}
+
+// ---------------------------------------------------------------------------
+// Virtual clock, timers and services
+// ---------------------------------------------------------------------------
+
+struct AppTimer {
+  uint32_t fire_ms;
+  AppTimerCallback callback;
+  void *data;
+  bool pending;
+  AppTimer *next;
+};
+
+static time_t s_start_time;
+static uint32_t s_now_ms;
+// Timers are never freed so stale handles held by the app stay harmless
+static AppTimer *s_timers;
+static HostScenario s_scenario;
+static HostFrameHook s_frame_hook;
+static uint32_t s_frame_count;
+
+static TickHandler s_tick_handler;
+static TimeUnits s_tick_units;
+static BatteryStateHandler s_battery_handler;
+static AccelTapHandler s_tap_handler;
+static BatteryChargeState s_battery_state = {.charge_percent = 70};
+static HealthEventHandler s_health_handler;
+static int32_t s_steps;
+static AppMessageInboxReceived s_inbox_handler;
+static uint32_t s_inbox_size;
+
+time_t pebble_host_time(time_t *tloc) {
+  time_t now = s_start_time + s_now_ms / 1000;
+  if (tloc) *tloc = now;
+  return now;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  pebble_host_time(tloc);
+  uint16_t ms = (uint16_t)(s_now_ms % 1000);
+  if (out_ms) *out_ms = ms;
+  return ms;
+}
+
+time_t time_start_of_today(void) {
+  time_t now = pebble_host_time(NULL);
+  struct tm day = *localtime(&now);
+  day.tm_hour = day.tm_min = day.tm_sec = 0;
+  return mktime(&day);
+}
+
+uint32_t host_now_ms(void) {
+  return s_now_ms;
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  AppTimer *timer = calloc(1, sizeof(AppTimer));
+  timer->fire_ms = s_now_ms + timeout_ms;
+  timer->callback = callback;
+  timer->data = callback_data;
+  timer->pending = true;
+  timer->next = s_timers;
+  s_timers = timer;
+  return timer;
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  if (!timer_handle || !timer_handle->pending) return false;
+  timer_handle->fire_ms = s_now_ms + new_timeout_ms;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) timer_handle->pending = false;
+}
+
+static AppTimer *prv_next_timer(void) {
+  AppTimer *next = NULL;
+  for (AppTimer *timer = s_timers; timer; timer = timer->next) {
+    if (timer->pending && (!next || timer->fire_ms < next->fire_ms)) next = timer;
+  }
+  return next;
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+}
+
+// Virtual time of the next tick event, or UINT32_MAX if none
+static uint32_t prv_next_tick_ms(void) {
+  if (!s_tick_handler) return UINT32_MAX;
+  uint32_t period = (s_tick_units & SECOND_UNIT) ? 1 : 60;
+  uint32_t now_s = (uint32_t)(s_start_time + s_now_ms / 1000);
+  uint32_t next_s = (now_s / period + 1) * period;
+  return (uint32_t)(next_s - s_start_time) * 1000;
+}
+
+static TimeUnits prv_units_changed(const struct tm *old_tm, const struct tm *new_tm) {
+  TimeUnits units = 0;
+  if (old_tm->tm_sec != new_tm->tm_sec) units |= SECOND_UNIT;
+  if (old_tm->tm_min != new_tm->tm_min) units |= MINUTE_UNIT;
+  if (old_tm->tm_hour != new_tm->tm_hour) units |= HOUR_UNIT;
+  if (old_tm->tm_mday != new_tm->tm_mday) units |= DAY_UNIT;
+  if (old_tm->tm_mon != new_tm->tm_mon) units |= MONTH_UNIT;
+  if (old_tm->tm_year != new_tm->tm_year) units |= YEAR_UNIT;
+  return units;
+}
+
+void host_flush(void) {
+  if (!s_window_dirty) return;
+  host_render(false);
+  if (s_frame_hook) s_frame_hook(s_frame_buffer, s_frame_count);
+  s_frame_count++;
+}
+
+void host_run_until(uint32_t end_ms) {
+  for (;;) {
+    AppTimer *timer = prv_next_timer();
+    uint32_t timer_ms = timer ? timer->fire_ms : UINT32_MAX;
+    uint32_t tick_ms = prv_next_tick_ms();
+    uint32_t next_ms = timer_ms < tick_ms ? timer_ms : tick_ms;
+    if (next_ms > end_ms) break;
+    if (tick_ms <= timer_ms) {
+      time_t before = s_start_time + s_now_ms / 1000;
+      struct tm old_tm = *localtime(&before);
+      s_now_ms = tick_ms;
+      time_t now = s_start_time + s_now_ms / 1000;
+      struct tm new_tm = *localtime(&now);
+      host_stats.tick_wakeups++;
+      s_tick_handler(&new_tm, prv_units_changed(&old_tm, &new_tm));
+    } else {
+      if (timer->fire_ms > s_now_ms) s_now_ms = timer->fire_ms;
+      timer->pending = false;
+      host_stats.timer_wakeups++;
+      timer->callback(timer->data);
+    }
+    host_flush();
+  }
+  if (end_ms > s_now_ms) s_now_ms = end_ms;
+}
+
+bool host_run_until_idle(uint32_t max_ms) {
+  uint32_t end_ms = s_now_ms + max_ms;
+  for (;;) {
+    AppTimer *timer = prv_next_timer();
+    if (!timer) return true;
+    if (timer->fire_ms > end_ms) return false;
+    host_run_until(timer->fire_ms);
+  }
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery_state;
+}
+
+void host_set_battery(uint8_t charge_percent) {
+  s_battery_state.charge_percent = charge_percent;
+  if (s_battery_handler) {
+    s_battery_handler(s_battery_state);
+    host_flush();
+  }
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+static UnobstructedAreaHandlers s_unobstructed_handlers;
+static void *s_unobstructed_context;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context) {
+  s_unobstructed_handlers = handlers;
+  s_unobstructed_context = context;
+}
+
+void unobstructed_area_service_unsubscribe(void) {
+  memset(&s_unobstructed_handlers, 0, sizeof(s_unobstructed_handlers));
+}
+#endif
+
+void host_slide_obstruction(int16_t height, int frames) {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  UnobstructedAreaHandlers *handlers = &s_unobstructed_handlers;
+  int16_t from = s_unobstructed_bottom;
+  int16_t to = (int16_t)(PBL_DISPLAY_HEIGHT - height);
+  if (handlers->will_change) {
+    handlers->will_change(GRect(0, 0, PBL_DISPLAY_WIDTH, to), s_unobstructed_context);
+  }
+  for (int frame = 1; frame <= frames; frame++) {
+    s_unobstructed_bottom = (int16_t)(from + (to - from) * frame / frames);
+    if (handlers->change) {
+      handlers->change(ANIMATION_NORMALIZED_MAX * frame / frames, s_unobstructed_context);
+    }
+    host_flush();
+  }
+  s_unobstructed_bottom = to;
+  if (handlers->did_change) handlers->did_change(s_unobstructed_context);
+  host_flush();
+#endif
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {
+  s_tap_handler = handler;
+}
+
+void accel_tap_service_unsubscribe(void) {
+  s_tap_handler = NULL;
+}
+
+void host_cover_window(void) {
+  Window *window = s_top_window;
+  if (!window) return;
+  if (window->handlers.disappear) window->handlers.disappear(window);
+  memset(s_frame_buffer->addr, 0xaa, (size_t)s_frame_buffer->row_size_bytes * PBL_DISPLAY_HEIGHT);
+  if (window->handlers.appear) window->handlers.appear(window);
+  s_window_dirty = true;
+  host_flush();
+}
+
+void host_tap(void) {
+  if (s_tap_handler) {
+    s_tap_handler(ACCEL_AXIS_Z, 1);
+    host_flush();
+  }
+}
+
+#ifdef PBL_HEALTH
+static void prv_health_initial_update(void *context) {
+  if (s_health_handler) s_health_handler(HealthEventSignificantUpdate, context);
+}
+#endif
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+#ifdef PBL_HEALTH
+  // Like the firmware, deliver an initial update shortly after subscribing
+  s_health_handler = handler;
+  app_timer_register(0, prv_health_initial_update, context);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool health_service_events_unsubscribe(void) {
+  s_health_handler = NULL;
+  return true;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+#ifdef PBL_HEALTH
+  host_stats.health_queries++;
+  return metric == HealthMetricStepCount ? s_steps : 0;
+#else
+  return 0;
+#endif
+}
+
+#ifdef PBL_HEALTH
+// Synthetic minute steps: none at night, walking on some daytime minutes
+static uint8_t prv_minute_steps(time_t minute) {
+  int hour = localtime(&minute)->tm_hour;
+  if (hour < 7 || hour >= 22) return 0;
+  uint32_t hash = (uint32_t)(minute / 60) * 2654435761u;
+  return (uint8_t)((hash >> 24) % (hour % 4 == 0 ? 120 : 30));
+}
+#endif
+
+// Minutes recorded up to now, as the firmware has them
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+                                           time_t *time_start, time_t *time_end) {
+#ifdef PBL_HEALTH
+  host_stats.health_queries++;
+  time_t now = pebble_host_time(NULL);
+  time_t start = *time_start / 60 * 60;
+  time_t end = (*time_end < now ? *time_end : now) / 60 * 60;
+  uint32_t count = 0;
+  for (time_t minute = start; minute < end && count < max_records; minute += 60) {
+    minute_data[count++] = (HealthMinuteData){.steps = prv_minute_steps(minute)};
+  }
+  *time_start = start;
+  *time_end = start + (time_t)count * 60;
+  return count;
+#else
+  return 0;
+#endif
+}
+
+void host_set_steps(int32_t steps) {
+  s_steps = steps;
+  if (s_health_handler) {
+    s_health_handler(HealthEventMovementUpdate, NULL);
+    host_flush();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Persistent storage
+// ---------------------------------------------------------------------------
+
+#define PERSIST_MAX_KEYS 64
+
+typedef struct {
+  uint32_t key;
+  bool used;
+  uint16_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry s_persist[PERSIST_MAX_KEYS];
+
+static PersistEntry *prv_persist_find(uint32_t key, bool create) {
+  PersistEntry *free_entry = NULL;
+  for (int i = 0; i < PERSIST_MAX_KEYS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) return &s_persist[i];
+    if (!s_persist[i].used && !free_entry) free_entry = &s_persist[i];
+  }
+  if (!create || !free_entry) return NULL;
+  free_entry->used = true;
+  free_entry->key = key;
+  free_entry->size = 0;
+  return free_entry;
+}
+
+bool persist_exists(const uint32_t key) {
+  return prv_persist_find(key, false) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+  PersistEntry *entry = prv_persist_find(key, false);
+  return entry ? entry->size : E_DOES_NOT_EXIST;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  PersistEntry *entry = prv_persist_find(key, false);
+  if (!entry) return E_DOES_NOT_EXIST;
+  size_t size = entry->size < buffer_size ? entry->size : buffer_size;
+  memcpy(buffer, entry->data, size);
+  return (int)size;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  PersistEntry *entry = prv_persist_find(key, true);
+  if (!entry) return E_ERROR;
+  host_stats.persist_writes++;
+  entry->size = (uint16_t)(size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH);
+  memcpy(entry->data, data, entry->size);
+  return entry->size;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+bool persist_read_bool(const uint32_t key) {
+  return persist_read_int(key) != 0;
+}
+
+status_t persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+status_t persist_write_bool(const uint32_t key, const bool value) {
+  return persist_write_int(key, value ? 1 : 0);
+}
+
+status_t persist_delete(const uint32_t key) {
+  PersistEntry *entry = prv_persist_find(key, false);
+  if (!entry) return E_DOES_NOT_EXIST;
+  entry->used = false;
+  return S_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Dictionaries and AppMessage
+// ---------------------------------------------------------------------------
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  iter->cursor = (Tuple *)(iter->dictionary + 1);
+  if (iter->dictionary[0] == 0 || (const uint8_t *)iter->cursor >= iter->end) return NULL;
+  return iter->cursor;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  Tuple *next = (Tuple *)((uint8_t *)iter->cursor + sizeof(Tuple) + iter->cursor->length);
+  if ((const uint8_t *)next >= iter->end) return NULL;
+  iter->cursor = next;
+  return next;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  DictionaryIterator copy = *iter;
+  for (Tuple *tuple = dict_read_first(&copy); tuple; tuple = dict_read_next(&copy)) {
+    if (tuple->key == key) return tuple;
+  }
+  return NULL;
+}
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *const buffer, const uint16_t size) {
+  if (!buffer || size < 1) return DICT_INVALID_ARGS;
+  buffer[0] = 0;
+  iter->dictionary = buffer;
+  iter->end = buffer + size;
+  iter->cursor = (Tuple *)(buffer + 1);
+  return DICT_OK;
+}
+
+static DictionaryResult prv_dict_write(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                       const void *data, uint16_t length) {
+  if ((const uint8_t *)iter->cursor + sizeof(Tuple) + length > iter->end) {
+    return DICT_NOT_ENOUGH_STORAGE;
+  }
+  iter->cursor->key = key;
+  iter->cursor->type = type;
+  iter->cursor->length = length;
+  memcpy(iter->cursor->value, data, length);
+  ((uint8_t *)iter->dictionary)[0]++;
+  iter->cursor = (Tuple *)((uint8_t *)iter->cursor + sizeof(Tuple) + length);
+  return DICT_OK;
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+  return prv_dict_write(iter, key, TUPLE_INT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *const cstring) {
+  return prv_dict_write(iter, key, TUPLE_CSTRING, cstring, (uint16_t)(strlen(cstring) + 1));
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *const data, const uint16_t size) {
+  return prv_dict_write(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+  iter->end = (const uint8_t *)iter->cursor;
+  return (uint32_t)(iter->end - iter->dictionary);
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  AppMessageInboxReceived previous = s_inbox_handler;
+  s_inbox_handler = received_callback;
+  return previous;
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  s_inbox_size = size_inbound;
+  return APP_MSG_OK;
+}
+
+bool host_deliver_message(const uint8_t *data, uint32_t size) {
+  if (!s_inbox_handler) return false;
+  if (size > s_inbox_size) {
+    fprintf(stderr, "warning: %u byte message dropped (inbox is %u bytes)\n", size, s_inbox_size);
+    return false;
+  }
+  DictionaryIterator iter = {.dictionary = data, .end = data + size};
+  s_inbox_handler(&iter, NULL);
+  host_flush();
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// App lifecycle
+// ---------------------------------------------------------------------------
+
+void app_event_loop(void) {
+  if (s_scenario) s_scenario();
+}
+
+void host_set_scenario(HostScenario scenario) {
+  s_scenario = scenario;
+}
+
+void host_set_frame_hook(HostFrameHook hook) {
+  s_frame_hook = hook;
+  s_frame_count = 0;
+}
+
+void host_reset_stats(void) {
+  memset(&host_stats, 0, sizeof(host_stats));
+  host_stats.heap_peak = s_heap_used;
+}
+
+void host_reset(time_t start_time) {
+  s_start_time = start_time;
+  s_now_ms = 0;
+  s_timers = NULL;
+  s_scenario = NULL;
+  s_frame_hook = NULL;
+  s_frame_count = 0;
+  s_tick_handler = NULL;
+  s_battery_handler = NULL;
+  s_tap_handler = NULL;
+  s_unobstructed_bottom = PBL_DISPLAY_HEIGHT;
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  memset(&s_unobstructed_handlers, 0, sizeof(s_unobstructed_handlers));
+#endif
+  s_health_handler = NULL;
+  s_inbox_handler = NULL;
+  s_top_window = NULL;
+  s_window_dirty = false;
+  if (!s_frame_buffer) {
+    s_frame_buffer = calloc(1, sizeof(GBitmap));
+    s_frame_buffer->format = FRAME_BUFFER_FORMAT;
+    s_frame_buffer->bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+    s_frame_buffer->row_size_bytes = prv_row_size(FRAME_BUFFER_FORMAT, PBL_DISPLAY_WIDTH);
+    s_frame_buffer->addr = calloc(1, (size_t)s_frame_buffer->row_size_bytes * PBL_DISPLAY_HEIGHT);
+  }
+  host_reset_stats();
+}
@@ -0,0 +1,64 @@
+#pragma once
+// Harness-side controls for the host Pebble stub (not visible to app code).
+#include <pebble.h>
+
+// Per-render graphics counters, reset by host_reset_stats()
+typedef struct {
+  uint32_t renders;
+  uint32_t fill_rects;
+  uint32_t fill_color_changes;
+  uint32_t bitmap_draws;
+  uint32_t frame_buffer_captures;
+  uint32_t timer_wakeups;
+  uint32_t tick_wakeups;
+  uint32_t persist_writes;
+  uint32_t health_queries;
+  size_t heap_peak;
+} HostStats;
+
+extern HostStats host_stats;
+void host_reset_stats(void);
+
+// Called with the framebuffer after every render
+typedef void (*HostFrameHook)(const GBitmap *frame_buffer, uint32_t frame);
+// Runs inside app_event_loop() in place of the real event loop
+typedef void (*HostScenario)(void);
+
+// Reset all services and set the virtual wall clock
+void host_reset(time_t start_time);
+void host_set_scenario(HostScenario scenario);
+void host_set_frame_hook(HostFrameHook hook);
+
+// Allow graphics_capture_frame_buffer (off exercises the fill_rect fallbacks)
+void host_set_frame_buffer_capture(bool enabled);
+
+void host_set_battery(uint8_t charge_percent);
+void host_set_steps(int32_t steps);
+// Deliver a wrist tap to the accel tap subscriber
+void host_tap(void);
+// Cover the app's window with another one (leaving its pixels in the
+// framebuffer) and return to it, like a dismissed notification
+void host_cover_window(void);
+// Slide an obstruction of the given height (0 to remove it) in from the
+// bottom over the given number of frames, like Quick View (not on Aplite)
+void host_slide_obstruction(int16_t height, int frames);
+
+// Virtual clock in ms since host_reset()
+uint32_t host_now_ms(void);
+// Dispatch timers and tick events up to the given virtual time, rendering after
+// every event that dirtied the window
+void host_run_until(uint32_t end_ms);
+// Dispatch timers until none are pending or max_ms elapsed; returns true if idle
+bool host_run_until_idle(uint32_t max_ms);
+
+// Deliver an AppMessage built with dict_write_*; false if it exceeds the inbox
+bool host_deliver_message(const uint8_t *data, uint32_t size);
+
+// Render the window stack (force ignores the dirty flag)
+void host_render(bool force);
+// Render if anything is dirty and pass the frame to the frame hook
+void host_flush(void);
+const GBitmap *host_frame_buffer(void);
+
+// Heap budget of the current platform, used by heap_bytes_free()
+size_t host_heap_size(void);
@@ -0,0 +1,207 @@
+// Minimal deterministic PNG encoder: 8-bit indexed color with the 64-color
+// Pebble palette, compressed with a greedy fixed-Huffman deflate that only
+// looks for runs (distance 1) and repeats of the previous row. Watchface
+// frames are mostly flat background, so that is enough to keep them small.
+#define PEBBLE_HOST_IMPL
+#include "png.h"
+#include <stdio.h>
+
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+  uint32_t bit_buffer;
+  int bit_count;
+} ByteStream;
+
+static void prv_put_byte(ByteStream *stream, uint8_t byte) {
+  if (stream->size == stream->capacity) {
+    stream->capacity = stream->capacity ? stream->capacity * 2 : 4096;
+    stream->data = realloc(stream->data, stream->capacity);
+  }
+  stream->data[stream->size++] = byte;
+}
+
+static void prv_put_u32(ByteStream *stream, uint32_t value) {
+  prv_put_byte(stream, (uint8_t)(value >> 24));
+  prv_put_byte(stream, (uint8_t)(value >> 16));
+  prv_put_byte(stream, (uint8_t)(value >> 8));
+  prv_put_byte(stream, (uint8_t)value);
+}
+
+// Deflate bit packing: values LSB first
+static void prv_put_bits(ByteStream *stream, uint32_t value, int count) {
+  stream->bit_buffer |= value << stream->bit_count;
+  stream->bit_count += count;
+  while (stream->bit_count >= 8) {
+    prv_put_byte(stream, (uint8_t)stream->bit_buffer);
+    stream->bit_buffer >>= 8;
+    stream->bit_count -= 8;
+  }
+}
+
+// Huffman codes are packed MSB first
+static void prv_put_code(ByteStream *stream, uint32_t code, int length) {
+  uint32_t reversed = 0;
+  for (int i = 0; i < length; i++) {
+    reversed = (reversed << 1) | ((code >> i) & 1);
+  }
+  prv_put_bits(stream, reversed, length);
+}
+
+static void prv_put_symbol(ByteStream *stream, int symbol) {
+  if (symbol < 144) {
+    prv_put_code(stream, 0x30 + symbol, 8);
+  } else if (symbol < 256) {
+    prv_put_code(stream, 0x190 + symbol - 144, 9);
+  } else if (symbol < 280) {
+    prv_put_code(stream, symbol - 256, 7);
+  } else {
+    prv_put_code(stream, 0xc0 + symbol - 280, 8);
+  }
+}
+
+static const uint16_t s_length_base[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t s_length_extra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t s_dist_base[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t s_dist_extra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static void prv_put_match(ByteStream *stream, int length, int distance) {
+  int code = 28;
+  while (s_length_base[code] > length) code--;
+  prv_put_symbol(stream, 257 + code);
+  prv_put_bits(stream, (uint32_t)(length - s_length_base[code]), s_length_extra[code]);
+  code = 29;
+  while (s_dist_base[code] > distance) code--;
+  prv_put_code(stream, (uint32_t)code, 5);
+  prv_put_bits(stream, (uint32_t)(distance - s_dist_base[code]), s_dist_extra[code]);
+}
+
+static int prv_match_length(const uint8_t *data, size_t size, size_t pos, size_t distance) {
+  if (distance > pos) return 0;
+  int length = 0;
+  while (length < 258 && pos + length < size && data[pos + length] == data[pos + length - distance]) {
+    length++;
+  }
+  return length;
+}
+
+static void prv_deflate(ByteStream *stream, const uint8_t *data, size_t size, size_t row_distance) {
+  prv_put_bits(stream, 1, 1);  // BFINAL
+  prv_put_bits(stream, 1, 2);  // Fixed Huffman
+  size_t pos = 0;
+  while (pos < size) {
+    int run = prv_match_length(data, size, pos, 1);
+    int row = prv_match_length(data, size, pos, row_distance);
+    if (run >= 3 && run >= row) {
+      prv_put_match(stream, run, 1);
+      pos += run;
+    } else if (row >= 3) {
+      prv_put_match(stream, row, (int)row_distance);
+      pos += row;
+    } else {
+      prv_put_symbol(stream, data[pos++]);
+    }
+  }
+  prv_put_symbol(stream, 256);
+  if (stream->bit_count > 0) prv_put_bits(stream, 0, 8 - stream->bit_count);
+}
+
+static uint32_t s_crc_table[256];
+
+static uint32_t prv_crc(const uint8_t *data, size_t size) {
+  if (!s_crc_table[1]) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      s_crc_table[n] = c;
+    }
+  }
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; i++) crc = s_crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffu;
+}
+
+static void prv_put_chunk(ByteStream *out, const char *type, const uint8_t *data, size_t size) {
+  prv_put_u32(out, (uint32_t)size);
+  size_t start = out->size;
+  for (int i = 0; i < 4; i++) prv_put_byte(out, (uint8_t)type[i]);
+  for (size_t i = 0; i < size; i++) prv_put_byte(out, data[i]);
+  prv_put_u32(out, prv_crc(out->data + start, out->size - start));
+}
+
+bool png_write_frame_buffer(const char *path, const GBitmap *frame_buffer) {
+  GRect bounds = gbitmap_get_bounds(frame_buffer);
+  int width = bounds.size.w;
+  int height = bounds.size.h;
+  GBitmapFormat format = gbitmap_get_format(frame_buffer);
+
+  // Filter byte + one palette index (the low 6 bits of GColor8) per pixel
+  size_t row_size = (size_t)width + 1;
+  uint8_t *raw = calloc(row_size, height);
+  for (int y = 0; y < height; y++) {
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, (uint16_t)y);
+    uint8_t *out = raw + y * row_size + 1;
+    for (int x = info.min_x; x <= info.max_x; x++) {
+      if (format == GBitmapFormat1Bit) {
+        out[x] = ((info.data[x / 8] >> (x % 8)) & 1) ? 0x3f : 0x00;
+      } else {
+        out[x] = info.data[x] & 0x3f;
+      }
+    }
+  }
+
+  ByteStream idat = {0};
+  prv_put_byte(&idat, 0x78);
+  prv_put_byte(&idat, 0x01);
+  prv_deflate(&idat, raw, row_size * height, row_size);
+  uint32_t a = 1, b = 0;
+  for (size_t i = 0; i < row_size * height; i++) {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  prv_put_u32(&idat, (b << 16) | a);
+  free(raw);
+
+  uint8_t header[13] = {0};
+  header[0] = (uint8_t)(width >> 24); header[1] = (uint8_t)(width >> 16);
+  header[2] = (uint8_t)(width >> 8); header[3] = (uint8_t)width;
+  header[4] = (uint8_t)(height >> 24); header[5] = (uint8_t)(height >> 16);
+  header[6] = (uint8_t)(height >> 8); header[7] = (uint8_t)height;
+  header[8] = 8;  // Bit depth
+  header[9] = 3;  // Indexed color
+
+  uint8_t palette[64 * 3];
+  for (int i = 0; i < 64; i++) {
+    palette[i * 3 + 0] = (uint8_t)(((i >> 4) & 3) * 85);
+    palette[i * 3 + 1] = (uint8_t)(((i >> 2) & 3) * 85);
+    palette[i * 3 + 2] = (uint8_t)((i & 3) * 85);
+  }
+
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  ByteStream png = {0};
+  for (int i = 0; i < 8; i++) prv_put_byte(&png, signature[i]);
+  prv_put_chunk(&png, "IHDR", header, sizeof(header));
+  prv_put_chunk(&png, "PLTE", palette, sizeof(palette));
+  prv_put_chunk(&png, "IDAT", idat.data, idat.size);
+  prv_put_chunk(&png, "IEND", NULL, 0);
+  free(idat.data);
+
+  FILE *file = fopen(path, "wb");
+  bool ok = file && fwrite(png.data, 1, png.size, file) == png.size;
+  if (file) fclose(file);
+  free(png.data);
+  return ok;
+}
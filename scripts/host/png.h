@@ -0,0 +1,9 @@
+#pragma once
+// Minimal deterministic PNG encoder for host renders.
+// Identical pixels always produce identical files, so golden images can be
+// compared byte for byte.
+#include <pebble.h>
+
+// Write the framebuffer (any supported GBitmapFormat) as an indexed PNG.
+// Pixels outside a round display are written black.
+bool png_write_frame_buffer(const char *path, const GBitmap *frame_buffer);
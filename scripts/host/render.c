@@ -0,0 +1,418 @@
+// Host render driver.
+// Runs the real watchface code against the stub SDK: every scenario first
+// launches the face and sends the settings over AppMessage (as the phone
+// would), then relaunches it and captures the resulting frames as PNGs.
+// Each scenario runs in its own forked process so app statics start clean.
+#define PEBBLE_HOST_IMPL
+#include "pebble_host.h"
+#include "png.h"
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int pebble_app_main(void);
+void animations_set_seed(uint32_t seed);
+
+// 2026-02-14 13:59:00 UTC: the first tick rolls three digits over to 14:00
+#define DEFAULT_START_TIME 1771077540
+#define STEPS 5234
+#define BATTERY_PERCENT 70
+#define WEATHER_TEMPERATURE 21
+// Quick View height on rectangular screens, slid in over this many frames
+#define QUICK_VIEW_HEIGHT 51
+#define QUICK_VIEW_FRAMES 8
+// Load animations run for about 1.5 s; leave room for slow pacing
+#define SETTLE_MS 5000
+// Load animation seed, so the random cells match between runs
+#define DEFAULT_SEED 0x67726964
+
+typedef struct {
+  uint8_t date_left;
+  uint8_t date_right;
+  bool show_weather;
+  bool show_corners;
+  bool use_24h;
+  bool show_seconds;
+  uint8_t load_animation;
+  uint8_t step_display;
+} Settings;
+
+static const char *s_out_dir;
+static const char *s_only;
+static time_t s_start_time = DEFAULT_START_TIME;
+static uint32_t s_seed = DEFAULT_SEED;
+static bool s_fill_rect;
+static Settings s_settings;
+static char s_name[64];
+
+// ---------------------------------------------------------------------------
+// Settings messages
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  uint8_t buffer[256];
+  DictionaryIterator iter;
+} Message;
+
+static void prv_message_begin(Message *message) {
+  dict_write_begin(&message->iter, message->buffer, sizeof(message->buffer));
+}
+
+static void prv_message_send(Message *message) {
+  uint32_t size = dict_write_end(&message->iter);
+  if (message->buffer[0] > 0) host_deliver_message(message->buffer, size);
+  prv_message_begin(message);
+}
+
+static void prv_message_int(Message *message, uint32_t key, int32_t value) {
+  dict_write_int32(&message->iter, key, value);
+}
+
+// Same 8-bit color as GColorFromHEX
+static uint8_t prv_color8(uint32_t hex) {
+  return (uint8_t)(0xc0 | ((hex >> 22) & 3) << 4 | ((hex >> 14) & 3) << 2 | ((hex >> 6) & 3));
+}
+
+// The packed settings byte array, encoded as encodeSettings in index.js does
+static void prv_send_settings(void) {
+  uint16_t step_goal = 8000;
+  uint8_t flags = 0x01 | 0x02 | 0x04;  // Steps, battery, date
+  if (s_settings.use_24h) flags |= 0x08;
+  if (s_settings.show_weather) flags |= 0x10;
+  if (s_settings.show_corners) flags |= 0x40;
+  if (s_settings.show_seconds) flags |= 0x80;
+  const uint8_t settings[] = {
+    1,  // Version
+    prv_color8(0x000000), prv_color8(0xFFFFFF), prv_color8(0xAAAAAA),
+    (uint8_t)step_goal, (uint8_t)(step_goal >> 8),
+    s_settings.load_animation, s_settings.date_left, s_settings.date_right,
+    flags, s_settings.step_display,
+  };
+  
+  Message message;
+  prv_message_begin(&message);
+  dict_write_data(&message.iter, MESSAGE_KEY_SETTINGS, settings, sizeof(settings));
+  prv_message_send(&message);
+  
+  prv_message_int(&message, MESSAGE_KEY_WEATHER_TEMPERATURE, WEATHER_TEMPERATURE);
+  prv_message_send(&message);
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+static void prv_write_frame(const GBitmap *frame_buffer, const char *name) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.png", s_out_dir, name);
+  if (!png_write_frame_buffer(path, frame_buffer)) {
+    fprintf(stderr, "error: could not write %s\n", path);
+    exit(1);
+  }
+}
+
+static void prv_print_stats(const char *name, uint32_t frames) {
+  if (frames == 0) frames = 1;
+  printf("%-28s frames=%-3u fill_rects/frame=%-5u colors/frame=%-5u blits/frame=%-4u "
+         "fb_captures/frame=%-2u timer_wakeups=%-3u persist_writes=%-2u health_queries=%-3u heap_peak=%zu/%zu\n",
+         name, frames,
+         host_stats.fill_rects / frames, host_stats.fill_color_changes / frames,
+         host_stats.bitmap_draws / frames, host_stats.frame_buffer_captures / frames,
+         host_stats.timer_wakeups, host_stats.persist_writes, host_stats.health_queries,
+         host_stats.heap_peak, host_heap_size());
+}
+
+static void prv_scenario_configure(void) {
+  prv_send_settings();
+}
+
+// Static face: let any load animation finish, then time one full redraw
+static void prv_scenario_face(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_render(true);
+  prv_write_frame(host_frame_buffer(), s_name);
+  prv_print_stats(s_name, 1);
+}
+
+static void prv_capture_frame(const GBitmap *frame_buffer, uint32_t frame) {
+  char name[96];
+  snprintf(name, sizeof(name), "%s_%02u", s_name, frame);
+  prv_write_frame(frame_buffer, name);
+}
+
+// Load animation: capture every frame from launch until the face settles
+static void prv_scenario_animation(void) {
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  host_flush();
+  host_run_until_idle(SETTLE_MS);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Digit transition: settle, then capture every frame across the next minute tick
+static void prv_scenario_tick(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  uint32_t next_minute_ms = (uint32_t)(60 - s_start_time % 60) * 1000;
+  host_run_until(next_minute_ms);
+  host_run_until_idle(SETTLE_MS);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Meter updates: small step and battery changes, capturing only the frames
+// that actually render, then the last morph running to its end
+static void prv_scenario_meters(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  for (int i = 1; i <= 50; i++) {
+    host_set_steps(STEPS + i * 20);
+  }
+  for (int percent = BATTERY_PERCENT - 1; percent >= BATTERY_PERCENT - 20; percent--) {
+    host_set_battery((uint8_t)percent);
+  }
+  host_run_until_idle(SETTLE_MS);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Seconds: the ticks up to and across a minute, then going to sleep after
+// the idle timeout (120 s without a tap) and a wrist tap waking them again
+static void prv_scenario_seconds(void) {
+  uint32_t next_minute_ms = (uint32_t)(60 - s_start_time % 60) * 1000;
+  host_run_until(next_minute_ms - 4000);
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  host_run_until(next_minute_ms + 2000);
+  host_run_until_idle(SETTLE_MS);
+  
+  host_set_frame_hook(NULL);
+  host_run_until(119 * 1000);
+  snprintf(s_name, sizeof(s_name), "seconds_sleep");
+  host_set_frame_hook(prv_capture_frame);
+  host_run_until(host_now_ms() + 3000);
+  
+  snprintf(s_name, sizeof(s_name), "seconds_wake");
+  host_set_frame_hook(prv_capture_frame);
+  host_tap();
+  host_run_until(host_now_ms() + 2000);
+  host_set_frame_hook(NULL);
+  snprintf(s_name, sizeof(s_name), "seconds");
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Quick View sliding in over the bottom of the face and back out
+static void prv_scenario_quick_view(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  host_slide_obstruction(QUICK_VIEW_HEIGHT, QUICK_VIEW_FRAMES);
+  host_slide_obstruction(0, QUICK_VIEW_FRAMES);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// A redraw after another window covered the face, with nothing changed
+static void prv_scenario_redraw(void) {
+  host_flush();
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  host_cover_window();
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Weather updates: a digit change morphs, a new digit count jumps
+static void prv_scenario_weather(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  static const int32_t temperatures[] = {24, 9};
+  for (int i = 0; i < 2; i++) {
+    Message message;
+    prv_message_begin(&message);
+    prv_message_int(&message, MESSAGE_KEY_WEATHER_TEMPERATURE, temperatures[i]);
+    prv_message_send(&message);
+    host_run_until_idle(SETTLE_MS);
+  }
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Step history: the launch reads nothing (the configure launch persisted
+// the hours), then the next hour is read ten minutes in and morphs in
+static void prv_scenario_history(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_render(true);
+  prv_write_frame(host_frame_buffer(), s_name);
+  uint32_t read_ms = (uint32_t)(60 - s_start_time % 60) * 1000 + 10 * 60 * 1000;
+  host_run_until(read_ms - 1000);
+  host_set_frame_hook(prv_capture_frame);
+  host_run_until(read_ms);
+  host_run_until_idle(SETTLE_MS);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+// Settings resent unchanged plus weather-only updates: nothing to persist
+static void prv_scenario_resend(void) {
+  host_run_until_idle(SETTLE_MS);
+  host_reset_stats();
+  host_set_frame_hook(prv_capture_frame);
+  prv_send_settings();
+  for (int i = 0; i < 3; i++) {
+    Message message;
+    prv_message_begin(&message);
+    prv_message_int(&message, MESSAGE_KEY_WEATHER_TEMPERATURE, WEATHER_TEMPERATURE);
+    prv_message_send(&message);
+  }
+  host_run_until_idle(SETTLE_MS);
+  host_set_frame_hook(NULL);
+  prv_print_stats(s_name, host_stats.renders);
+}
+
+static bool prv_selected(const char *name) {
+  return !s_only || strncmp(name, s_only, strlen(s_only)) == 0;
+}
+
+// Configure, relaunch and run the scenario in a child process
+static void prv_run(HostScenario scenario) {
+  if (!prv_selected(s_name)) return;
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    exit(1);
+  }
+  if (pid == 0) {
+    host_reset(s_start_time);
+    host_set_frame_buffer_capture(!s_fill_rect);
+    host_set_battery(BATTERY_PERCENT);
+    host_set_steps(STEPS);
+    animations_set_seed(s_seed);
+    host_set_scenario(prv_scenario_configure);
+    pebble_app_main();
+    host_set_scenario(scenario);
+    pebble_app_main();
+    fflush(stdout);
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "error: scenario %s failed\n", s_name);
+    exit(1);
+  }
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      s_out_dir = argv[++i];
+    } else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+      s_only = argv[++i];
+    } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+      s_start_time = (time_t)strtoll(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      s_seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "--fill-rect") == 0) {
+      s_fill_rect = true;
+    } else {
+      fprintf(stderr, "usage: %s --out DIR [--only PREFIX] [--time EPOCH] [--seed N] [--fill-rect]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!s_out_dir) {
+    fprintf(stderr, "usage: %s --out DIR [--only PREFIX] [--time EPOCH] [--seed N] [--fill-rect]\n", argv[0]);
+    return 2;
+  }
+  setenv("TZ", "UTC", 1);
+  tzset();
+  mkdir(s_out_dir, 0755);
+
+  // Every face/settings combination with the load animation off
+  for (int left = 0; left <= 5; left++) {
+    for (int right = 0; right <= 5; right++) {
+      for (int weather = 0; weather <= 1; weather++) {
+        for (int corners = 0; corners <= 1; corners++) {
+          for (int hours = 0; hours <= 1; hours++) {
+            s_settings = (Settings){
+              .date_left = (uint8_t)left, .date_right = (uint8_t)right,
+              .show_weather = weather, .show_corners = corners, .use_24h = hours,
+              .load_animation = 0,
+            };
+            snprintf(s_name, sizeof(s_name), "face_L%d_R%d_w%d_c%d_%dh",
+                     left, right, weather, corners, hours ? 24 : 12);
+            prv_run(prv_scenario_face);
+          }
+        }
+      }
+    }
+  }
+
+  // Load animations with the default face
+  static const char *animation_names[] = {"wave", "random", "matrix"};
+  for (int animation = 1; animation <= 3; animation++) {
+    s_settings = (Settings){.date_left = 3, .date_right = 4, .show_corners = true,
+                            .use_24h = true, .load_animation = (uint8_t)animation};
+    snprintf(s_name, sizeof(s_name), "anim_%s", animation_names[animation - 1]);
+    prv_run(prv_scenario_animation);
+  }
+
+  // Digit transition across a minute tick
+  s_settings = (Settings){.date_left = 3, .date_right = 4, .show_corners = true,
+                          .use_24h = true, .load_animation = 0};
+  snprintf(s_name, sizeof(s_name), "tick");
+  prv_run(prv_scenario_tick);
+
+  // Step count and battery updates
+  snprintf(s_name, sizeof(s_name), "meters");
+  prv_run(prv_scenario_meters);
+
+  // Seconds indicator
+  s_settings.show_seconds = true;
+  snprintf(s_name, sizeof(s_name), "seconds");
+  prv_run(prv_scenario_seconds);
+  s_settings.show_seconds = false;
+  
+  // Quick View with and without the weather
+  for (int weather = 0; weather <= 1; weather++) {
+    s_settings.show_weather = weather;
+    snprintf(s_name, sizeof(s_name), "quickview_w%d", weather);
+    prv_run(prv_scenario_quick_view);
+  }
+  s_settings.show_weather = false;
+  
+  // Redraw after a notification, with and without the seconds
+  for (int seconds = 0; seconds <= 1; seconds++) {
+    s_settings.show_seconds = seconds;
+    snprintf(s_name, sizeof(s_name), "redraw_s%d", seconds);
+    prv_run(prv_scenario_redraw);
+  }
+  s_settings.show_seconds = false;
+  
+  // Weather digits morphing
+  s_settings.show_weather = true;
+  snprintf(s_name, sizeof(s_name), "weather");
+  prv_run(prv_scenario_weather);
+  s_settings.show_weather = false;
+  
+  // Hourly step history in place of the step bar
+  s_settings.step_display = 1;
+  snprintf(s_name, sizeof(s_name), "history");
+  prv_run(prv_scenario_history);
+  s_settings.step_display = 0;
+  
+  // Unchanged settings and weather updates
+  snprintf(s_name, sizeof(s_name), "resend");
+  prv_run(prv_scenario_resend);
+  return 0;
+}
@@ -0,0 +1,218 @@
+// Mock PebbleKit JS runtime for running src/pkjs/index.js in node.
+// Timers and Date.now run on a virtual clock that only moves in advance();
+// geolocation, XMLHttpRequest, localStorage, Clay and the watch's
+// AppMessage replies are scripted by the check.
+'use strict';
+
+var fs = require('fs');
+var path = require('path');
+var vm = require('vm');
+
+var ROOT = path.join(__dirname, '..', '..');
+var INDEX_JS = path.join(ROOT, 'src', 'pkjs', 'index.js');
+var CONFIG_JSON = path.join(ROOT, 'src', 'pkjs', 'config.json');
+
+var GEOLOCATION_MS = 10;
+var XHR_MS = 100;
+
+// Shared across launches, like the phone's storage
+function createStorage() {
+  var items = {};
+  return {
+    getItem: function(key) { return key in items ? items[key] : null; },
+    setItem: function(key, value) { items[key] = String(value); },
+    removeItem: function(key) { delete items[key]; }
+  };
+}
+
+// Start index.js and send it 'ready'. Options: storage (from
+// createStorage), now (ms), location and weather (see below), seed (for
+// Math.random)
+function launch(options) {
+  options = options || {};
+  var env = {
+    now: options.now || 0,
+    storage: options.storage || createStorage(),
+    // Scripted by the check; a null location fails the position request
+    location: options.location !== undefined ? options.location : { lat: 52.37, lon: 4.89 },
+    weather: options.weather || { status: 200, temperature: 21.2 },
+    watch: function() { return { ack: true, latencyMs: 200 }; },
+    // Recorded
+    positionRequests: 0,
+    requests: [],       // XMLHttpRequests: {time, url}
+    sent: [],           // Every sendAppMessage: {time, message, acked}
+    openedUrls: [],
+    clayOptions: null,
+    timers: []
+  };
+  var listeners = {};
+  var nextTimerId = 1;
+  var random = options.seed || 1;
+
+  function setTimeout(fn, delay) {
+    var timer = { id: nextTimerId++, at: env.now + Math.max(0, delay || 0), fn: fn };
+    env.timers.push(timer);
+    return timer.id;
+  }
+
+  function clearTimeout(id) {
+    env.timers = env.timers.filter(function(timer) { return timer.id !== id; });
+  }
+
+  var Pebble = {
+    addEventListener: function(name, fn) {
+      (listeners[name] = listeners[name] || []).push(fn);
+    },
+    sendAppMessage: function(message, ack, nack) {
+      var record = { time: env.now, message: JSON.parse(JSON.stringify(message)), acked: null };
+      env.sent.push(record);
+      var reply = env.watch(record, env);
+      setTimeout(function() {
+        record.acked = reply.ack;
+        if (reply.ack) {
+          if (ack) ack({});
+        } else if (nack) {
+          nack({ error: 'busy' });
+        }
+      }, reply.latencyMs);
+    },
+    openURL: function(url) {
+      env.openedUrls.push(url);
+    }
+  };
+
+  // Clay as the real one behaves: with autoHandleEvents on it sends the
+  // whole settings dictionary itself when the page closes
+  function Clay(config, customFn, clayOptions) {
+    var clay = this;
+    env.clayOptions = clayOptions || {};
+    clay.generateUrl = function() { return 'data:text/html,clay'; };
+    clay.getSettings = function(response) {
+      var settings = JSON.parse(decodeURIComponent(response));
+      env.storage.setItem('clay-settings', JSON.stringify(settings));
+      return settings;
+    };
+    if (env.clayOptions.autoHandleEvents !== false) {
+      Pebble.addEventListener('showConfiguration', function() {
+        Pebble.openURL(clay.generateUrl());
+      });
+      Pebble.addEventListener('webviewclosed', function(e) {
+        if (e && e.response) Pebble.sendAppMessage(clay.getSettings(e.response));
+      });
+    }
+  }
+
+  function XMLHttpRequest() {
+    var xhr = this;
+    xhr.readyState = 0;
+    xhr.open = function(method, url) { xhr.url = url; };
+    xhr.send = function() {
+      env.requests.push({ time: env.now, url: xhr.url });
+      var weather = env.weather;
+      setTimeout(function() {
+        xhr.readyState = 4;
+        xhr.status = weather.status;
+        xhr.responseText = JSON.stringify({ current: { temperature_2m: weather.temperature } });
+        xhr.onreadystatechange();
+      }, XHR_MS);
+    };
+  }
+
+  var navigator = {
+    geolocation: {
+      getCurrentPosition: function(success, error) {
+        env.positionRequests++;
+        var location = env.location;
+        setTimeout(function() {
+          if (location) {
+            success({ coords: { latitude: location.lat, longitude: location.lon } });
+          } else {
+            error({ message: 'position unavailable' });
+          }
+        }, GEOLOCATION_MS);
+      }
+    }
+  };
+
+  var sandbox = {
+    Pebble: Pebble,
+    localStorage: env.storage,
+    navigator: navigator,
+    XMLHttpRequest: XMLHttpRequest,
+    setTimeout: setTimeout,
+    clearTimeout: clearTimeout,
+    console: { log: process.env.PKJS_LOG ? console.log : function() {} },
+    require: function(name) {
+      if (name === '@rebble/clay') return Clay;
+      if (name === './config.json') return JSON.parse(fs.readFileSync(CONFIG_JSON, 'utf8'));
+      throw new Error('unexpected require: ' + name);
+    }
+  };
+  vm.createContext(sandbox);
+  // Virtual clock and reproducible jitter
+  sandbox.nowMs = function() { return env.now; };
+  sandbox.nextRandom = function() {
+    random = (random * 1103515245 + 12345) % 2147483648;
+    return random / 2147483648;
+  };
+  vm.runInContext('Date.now = nowMs; Math.random = nextRandom;', sandbox);
+  vm.runInContext(fs.readFileSync(INDEX_JS, 'utf8'), sandbox, { filename: INDEX_JS });
+
+  env.emit = function(name, event) {
+    (listeners[name] || []).forEach(function(fn) { fn(event); });
+  };
+
+  // Run every timer due up to now + ms, in order
+  env.advance = function(ms) {
+    var end = env.now + ms;
+    for (;;) {
+      var due = env.timers.filter(function(timer) { return timer.at <= end; });
+      if (due.length === 0) break;
+      var timer = due.reduce(function(a, b) { return b.at < a.at ? b : a; });
+      clearTimeout(timer.id);
+      env.now = timer.at;
+      timer.fn();
+    }
+    env.now = end;
+  };
+
+  // The configuration page closing with these Clay settings
+  env.configure = function(settings) {
+    env.emit('webviewclosed', { response: encodeURIComponent(JSON.stringify(settings)) });
+  };
+
+  // Values of one key in the order the watch received them
+  env.delivered = function(key) {
+    return env.sent.filter(function(record) {
+      return record.acked && key in record.message;
+    }).map(function(record) {
+      return record.message[key];
+    });
+  };
+
+  env.emit('ready', {});
+  return env;
+}
+
+// Minimal runner: named checks, failures reported and counted
+function runChecks(checks) {
+  var failed = 0;
+  Object.keys(checks).forEach(function(name) {
+    try {
+      checks[name]();
+      console.log('ok   ' + name);
+    } catch (e) {
+      failed++;
+      console.log('FAIL ' + name + ': ' + e.message);
+    }
+  });
+  process.exitCode = failed > 0 ? 1 : 0;
+}
+
+module.exports = {
+  GEOLOCATION_MS: GEOLOCATION_MS,
+  XHR_MS: XHR_MS,
+  createStorage: createStorage,
+  launch: launch,
+  runChecks: runChecks
+};
@@ -0,0 +1,112 @@
+// AppMessage outbox in src/pkjs/index.js against a mocked watch that ACKs
+// or NACKs each message after a delay.
+// Usage: node scripts/pkjs/outbox.js (PKJS_LOG=1 shows the app's logs)
+'use strict';
+
+var assert = require('assert');
+var pkjs = require('./env');
+
+var LATENCY_MS = 200;
+var RETRY_MS = 500;
+var MAX_ATTEMPTS = 6;
+
+// Watch that NACKs a message when another one is still in flight (busy),
+// or when nack(record) says so
+function watch(env, nack) {
+  var busy = 0;
+  env.watch = function(record) {
+    var inFlight = env.sent.filter(function(other) { return other.acked === null; }).length;
+    if (inFlight > 1) busy++;
+    env.busy = busy;
+    return { ack: inFlight <= 1 && !(nack && nack(record)), latencyMs: LATENCY_MS };
+  };
+}
+
+function settingsWithGoal(goal) {
+  return { STEP_GOAL: goal, SHOW_STEPS: true, SHOW_WEATHER: false };
+}
+
+// Step goal bytes of a SETTINGS array (little-endian uint16 at 4)
+function goalOf(settings) {
+  return settings[4] | (settings[5] << 8);
+}
+
+pkjs.runChecks({
+  'settings go out only through the outbox': function() {
+    var env = pkjs.launch();
+    watch(env);
+    assert.strictEqual(env.clayOptions.autoHandleEvents, false);
+    env.emit('showConfiguration', {});
+    assert.strictEqual(env.openedUrls.length, 1);
+
+    env.configure(settingsWithGoal(9000));
+    env.advance(1000);
+    assert.strictEqual(env.sent.length, 1);
+    assert.deepStrictEqual(Object.keys(env.sent[0].message), ['SETTINGS']);
+    assert.strictEqual(goalOf(env.delivered('SETTINGS')[0]), 9000);
+  },
+
+  'quick saves merge with the cached temperature into one message': function() {
+    var storage = pkjs.createStorage();
+    var first = pkjs.launch({ storage: storage });
+    first.configure({ SHOW_WEATHER: true });
+    first.advance(1000);
+
+    var env = pkjs.launch({ storage: storage, now: first.now + 5 * 60 * 1000 });
+    watch(env);
+    env.configure(settingsWithGoal(9000));
+    env.configure({ STEP_GOAL: 12000, SHOW_WEATHER: true });
+    env.advance(1000);
+    assert.strictEqual(env.sent.length, 1);
+    assert.deepStrictEqual(Object.keys(env.sent[0].message).sort(), ['SETTINGS', 'WEATHER_TEMPERATURE']);
+    assert.strictEqual(goalOf(env.sent[0].message.SETTINGS), 12000);
+    assert.strictEqual(env.sent[0].message.WEATHER_TEMPERATURE, 21);
+  },
+
+  'one message is in flight at a time': function() {
+    var env = pkjs.launch();
+    watch(env);
+    env.configure({ STEP_GOAL: 9000, SHOW_WEATHER: true });
+    env.advance(50);
+    env.configure({ STEP_GOAL: 10000, SHOW_WEATHER: true });
+    env.advance(50);
+    env.configure({ STEP_GOAL: 11000, SHOW_WEATHER: true });
+    env.advance(5000);
+    assert.strictEqual(env.busy, 0);
+    var goals = env.delivered('SETTINGS').map(goalOf);
+    assert.strictEqual(goals[goals.length - 1], 11000);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [21]);
+  },
+
+  'a value changed during retries is sent in its newest form': function() {
+    var env = pkjs.launch();
+    var attempts = 0;
+    watch(env, function() { return ++attempts <= 2; });
+    env.configure(settingsWithGoal(9000));
+    env.advance(LATENCY_MS + 10);
+    env.configure(settingsWithGoal(12000));
+    env.advance(10 * 1000);
+    assert.deepStrictEqual(env.delivered('SETTINGS').map(goalOf), [12000]);
+  },
+
+  'an unreachable watch is given up on after backing off': function() {
+    var env = pkjs.launch();
+    var reachable = false;
+    watch(env, function() { return !reachable; });
+    env.configure(settingsWithGoal(9000));
+    env.advance(60 * 1000);
+    assert.strictEqual(env.sent.length, MAX_ATTEMPTS);
+    for (var i = 1; i < env.sent.length; i++) {
+      var wait = env.sent[i].time - env.sent[i - 1].time - LATENCY_MS;
+      var base = RETRY_MS * Math.pow(2, i - 1);
+      assert.ok(wait >= base * 0.5 && wait <= base * 1.5, 'retry ' + i + ' waited ' + wait + ' ms');
+    }
+    assert.deepStrictEqual(env.delivered('SETTINGS'), []);
+
+    // Later messages still go out
+    reachable = true;
+    env.configure(settingsWithGoal(12000));
+    env.advance(1000);
+    assert.deepStrictEqual(env.delivered('SETTINGS').map(goalOf), [12000]);
+  }
+});
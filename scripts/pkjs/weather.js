@@ -0,0 +1,113 @@
+// Weather fetch gating, location cache and backoff in src/pkjs/index.js,
+// against mocked geolocation, XMLHttpRequest and localStorage.
+// Usage: node scripts/pkjs/weather.js (PKJS_LOG=1 shows the app's logs)
+'use strict';
+
+var assert = require('assert');
+var pkjs = require('./env');
+
+var MINUTE = 60 * 1000;
+var FETCH_MS = pkjs.GEOLOCATION_MS + pkjs.XHR_MS;
+// 0.1 degrees of latitude is about 11 km, 0.03 about 3 km
+var MOVED_FAR = { lat: 52.47, lon: 4.89 };
+var MOVED_NEAR = { lat: 52.40, lon: 4.89 };
+
+function requestTimes(env) {
+  return env.requests.map(function(request) { return request.time; });
+}
+
+// Launch, turn weather on and let the first fetch land
+function launchShown(options) {
+  var env = pkjs.launch(options);
+  env.configure({ SHOW_WEATHER: true });
+  env.advance(1000);
+  return env;
+}
+
+pkjs.runChecks({
+  'nothing is fetched while weather is hidden': function() {
+    var env = pkjs.launch();
+    env.configure({ SHOW_WEATHER: false });
+    env.advance(3 * 60 * MINUTE);
+    assert.strictEqual(env.positionRequests, 0);
+    assert.strictEqual(env.requests.length, 0);
+    assert.strictEqual(env.timers.length, 0);
+  },
+
+  'a temperature is sent once per rounded value': function() {
+    var env = launchShown();
+    assert.strictEqual(env.requests.length, 1);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [21]);
+
+    env.weather = { status: 200, temperature: 21.4 };
+    env.advance(30 * MINUTE);
+    assert.strictEqual(env.requests.length, 2);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [21]);
+
+    env.weather = { status: 200, temperature: 22.6 };
+    env.advance(30 * MINUTE);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [21, 23]);
+  },
+
+  'failed fetches back off and send nothing': function() {
+    var env = pkjs.launch({ weather: { status: 503, temperature: 0 } });
+    env.configure({ SHOW_WEATHER: true });
+    env.advance(8 * MINUTE);
+    var times = requestTimes(env);
+    var gaps = times.slice(1).map(function(time, i) { return time - times[i] - FETCH_MS; });
+    assert.deepStrictEqual(gaps, [MINUTE, 2 * MINUTE, 4 * MINUTE]);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), []);
+
+    // Recovers and resets the backoff
+    env.weather = { status: 200, temperature: 18 };
+    env.advance(8 * MINUTE);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [18]);
+  },
+
+  'a failed position request backs off without fetching': function() {
+    var env = pkjs.launch({ location: null });
+    env.configure({ SHOW_WEATHER: true });
+    env.advance(MINUTE + 1000);
+    assert.strictEqual(env.positionRequests, 2);
+    assert.strictEqual(env.requests.length, 0);
+  },
+
+  'a fresh cache is sent on relaunch without fetching': function() {
+    var storage = pkjs.createStorage();
+    var first = launchShown({ storage: storage });
+
+    var env = pkjs.launch({ storage: storage, now: first.now + 10 * MINUTE });
+    env.advance(1000);
+    assert.strictEqual(env.requests.length, 0);
+    assert.deepStrictEqual(env.delivered('WEATHER_TEMPERATURE'), [21]);
+
+    // Refetched once the cached value is 30 minutes old
+    env.advance(20 * MINUTE);
+    assert.strictEqual(env.requests.length, 1);
+  },
+
+  'moving more than 5 km refetches early': function() {
+    var storage = pkjs.createStorage();
+    var first = launchShown({ storage: storage });
+
+    var near = pkjs.launch({ storage: storage, now: first.now + 5 * MINUTE, location: MOVED_NEAR });
+    near.advance(1000);
+    assert.strictEqual(near.requests.length, 0);
+
+    var far = pkjs.launch({ storage: storage, now: near.now, location: MOVED_FAR });
+    far.advance(1000);
+    assert.strictEqual(far.requests.length, 1);
+    assert.ok(far.requests[0].url.indexOf('latitude=52.47') >= 0);
+  },
+
+  'turning weather off stops the refresh': function() {
+    var env = launchShown();
+    env.configure({ SHOW_WEATHER: false });
+    env.advance(1000);
+    var sent = env.sent.length;
+    env.advance(3 * 60 * MINUTE);
+    assert.strictEqual(env.requests.length, 1);
+    assert.strictEqual(env.sent.length, sent);
+    assert.strictEqual(env.timers.length, 0);
+  }
+});
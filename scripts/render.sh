@@ -0,0 +1,140 @@
+#!/bin/bash
+# Renders the watchface on the host (no emulator) for every platform in package.json
+# targetPlatforms: all face/settings combinations, the load animations, a digit
+# transition, step/battery updates, the seconds indicator, a Quick View slide, a redraw
+# after a notification, weather digit morphs, the step history and resent settings,
+# written as PNGs to build/host/<platform>/out with per-frame stats.
+#
+# Usage: scripts/render.sh [--update] [--only PREFIX] [--fill-rect] [--profile] [platform...]
+#   --update       store this run as the golden images (build/host/golden)
+#   --only PREFIX  only render scenarios whose name starts with PREFIX (e.g. face_L3_R4)
+#   --fill-rect    refuse framebuffer captures so drawing takes the fill_rect fallbacks
+#   --profile      build with GRIDSPACE_PROFILE_OVERLAY; frames show the overlay, so
+#                  they are not compared (set GRIDSPACE_LOG=1 to see the summaries)
+#
+# Without --update, the renders are compared against the golden images and the
+# script fails if any frame changed. Record goldens from a known-good commit first.
+set -e
+
+cd "$(dirname "$0")/.."
+ROOT=$(pwd)
+HOST_DIR="$ROOT/scripts/host"
+BUILD_DIR="$ROOT/build/host"
+GOLDEN_DIR="$BUILD_DIR/golden"
+CC=${CC:-cc}
+
+UPDATE=0
+ONLY=()
+RENDER_ARGS=()
+PROFILE_DEFINES=
+PLATFORMS=()
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --update) UPDATE=1 ;;
+    --only) ONLY=(--only "$2"); shift ;;
+    --fill-rect) RENDER_ARGS+=(--fill-rect) ;;
+    --profile) PROFILE_DEFINES="-DGRIDSPACE_PROFILE_OVERLAY" ;;
+    *) PLATFORMS+=("$1") ;;
+  esac
+  shift
+done
+
+if [ ${#PLATFORMS[@]} -eq 0 ]; then
+  PLATFORMS=($(node -p "require('./package.json').pebble.targetPlatforms.join(' ')"))
+fi
+
+# Generated by the SDK build in a real build; keys start at 10000 in declaration order
+mkdir -p "$BUILD_DIR/include"
+node -e "
+  var keys = require('./package.json').pebble.messageKeys;
+  var lines = ['#pragma once'];
+  keys.forEach(function(key, i) { lines.push('#define MESSAGE_KEY_' + key + ' ' + (10000 + i)); });
+  console.log(lines.join('\n'));
+" > "$BUILD_DIR/include/message_keys.auto.h"
+
+platform_defines() {
+  case "$1" in
+    aplite)  echo "-DPBL_PLATFORM_APLITE -DPBL_BW -DPBL_RECT" ;;
+    basalt)  echo "-DPBL_PLATFORM_BASALT -DPBL_COLOR -DPBL_RECT -DPBL_HEALTH" ;;
+    chalk)   echo "-DPBL_PLATFORM_CHALK -DPBL_COLOR -DPBL_ROUND -DPBL_HEALTH" ;;
+    diorite) echo "-DPBL_PLATFORM_DIORITE -DPBL_BW -DPBL_RECT -DPBL_HEALTH" ;;
+    emery)   echo "-DPBL_PLATFORM_EMERY -DPBL_COLOR -DPBL_RECT -DPBL_HEALTH" ;;
+    flint)   echo "-DPBL_PLATFORM_FLINT -DPBL_BW -DPBL_RECT -DPBL_HEALTH" ;;
+    gabbro)  echo "-DPBL_PLATFORM_GABBRO -DPBL_COLOR -DPBL_ROUND -DPBL_HEALTH" ;;
+    *) echo "Unknown platform: $1" >&2; exit 1 ;;
+  esac
+}
+
+CFLAGS="-std=gnu11 -O2 -Wall -Wextra -Wno-unused-parameter -Wno-missing-field-initializers"
+# The app's main() is renamed, so its implicit "return 0" no longer applies
+APP_CFLAGS="$CFLAGS -Dmain=pebble_app_main -Wno-return-type"
+
+build_and_render() {
+  local PLATFORM=$1
+  local DEFINES
+  DEFINES="$(platform_defines "$PLATFORM") $PROFILE_DEFINES"
+  local OUT="$BUILD_DIR/$PLATFORM"
+  rm -rf "$OUT/obj" "$OUT/out"
+  mkdir -p "$OUT/obj" "$OUT/out"
+
+  local OBJECTS=()
+  local SRC OBJ
+  for SRC in $(find src/c -name '*.c' | sort); do
+    OBJ="$OUT/obj/$(echo "${SRC#src/c/}" | tr '/' '_').o"
+    $CC $APP_CFLAGS $DEFINES -I"$HOST_DIR" -I"$BUILD_DIR/include" -c "$SRC" -o "$OBJ" || return 1
+    OBJECTS+=("$OBJ")
+  done
+  for SRC in "$HOST_DIR"/*.c; do
+    OBJ="$OUT/obj/host_$(basename "$SRC" .c).o"
+    $CC $CFLAGS $DEFINES -I"$HOST_DIR" -I"$BUILD_DIR/include" -c "$SRC" -o "$OBJ" || return 1
+    OBJECTS+=("$OBJ")
+  done
+  $CC "${OBJECTS[@]}" -lm -o "$OUT/render" || return 1
+  "$OUT/render" --out "$OUT/out" "${ONLY[@]}" "${RENDER_ARGS[@]}" > "$OUT/stats.txt"
+}
+
+# Platforms build and render in parallel; logs are printed in order afterwards
+PIDS=()
+for PLATFORM in "${PLATFORMS[@]}"; do
+  mkdir -p "$BUILD_DIR/$PLATFORM"
+  build_and_render "$PLATFORM" > "$BUILD_DIR/$PLATFORM/build.log" 2>&1 &
+  PIDS+=($!)
+done
+
+FAILED=0
+for i in "${!PLATFORMS[@]}"; do
+  PLATFORM=${PLATFORMS[$i]}
+  OUT="$BUILD_DIR/$PLATFORM"
+  if ! wait "${PIDS[$i]}"; then
+    cat "$OUT/build.log"
+    echo "$PLATFORM: build or render failed"
+    FAILED=1
+    continue
+  fi
+  cat "$OUT/build.log"
+  echo "$PLATFORM: $(ls "$OUT/out" | wc -l | tr -d ' ') frames, stats in ${OUT#$ROOT/}/stats.txt"
+
+  if [ $UPDATE -eq 1 ] && [ -z "$PROFILE_DEFINES" ]; then
+    rm -rf "$GOLDEN_DIR/$PLATFORM"
+    mkdir -p "$GOLDEN_DIR/$PLATFORM"
+    cp "$OUT"/out/*.png "$OUT/stats.txt" "$GOLDEN_DIR/$PLATFORM/"
+  elif [ -d "$GOLDEN_DIR/$PLATFORM" ] && [ -z "$PROFILE_DEFINES" ]; then
+    CHANGED=0
+    for PNG in "$OUT"/out/*.png; do
+      GOLDEN="$GOLDEN_DIR/$PLATFORM/$(basename "$PNG")"
+      if [ ! -f "$GOLDEN" ] || ! cmp -s "$PNG" "$GOLDEN"; then
+        [ $CHANGED -lt 10 ] && echo "  changed: $(basename "$PNG")"
+        CHANGED=$((CHANGED + 1))
+      fi
+    done
+    if [ $CHANGED -gt 0 ]; then
+      echo "  $CHANGED frame(s) differ from golden images"
+      FAILED=1
+    fi
+  fi
+done
+
+if [ $UPDATE -eq 0 ] && [ ! -d "$GOLDEN_DIR" ]; then
+  echo "No golden images yet; run with --update on a known-good commit to record them."
+fi
+exit $FAILED
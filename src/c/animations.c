@@ -1,59 +1,147 @@
 #include "animations.h"
-#include "animations/sideload.h"
 #include "animations/random.h"
 #include "animations/matrix.h"
+#include "wall_clock.h"
 #include <stdlib.h>
 
-// Random seed for animation
-static uint32_t s_random_seed = 0;
+// Seed override for reproducible runs (0 = seed from the clock)
+static uint32_t s_fixed_seed = 0;
 
-// Simple pseudo-random number generator
-static uint32_t random_next(void) {
-  s_random_seed = (s_random_seed * 1103515245 + 12345) & 0x7fffffff;
-  return s_random_seed;
-}
+// Load animations run for 50 frames at ~30 FPS, stepping on every frame clock tick
+#define FRAME_MS FRAME_CLOCK_MS
+#define DURATION_MS (50 * FRAME_MS)
+
+// Drawing a frame should leave room for the rest of the event loop; over
+// budget lowers the detail level, under half of it raises it again
+#define FRAME_BUDGET_MS 20
 
-static void animation_timer_callback(void *data);
+static bool animation_clock_step(void *data);
 
 void animations_init(AnimationState *state) {
   state->type = ANIM_NONE;
-  state->progress = 0.0f;
-  state->fade = 1.0f;
+  timeline_start(&state->timeline, DURATION_MS);
+  state->progress = 0;
+  state->fade = FIXED_ONE;
   state->active = false;
-  state->timer = NULL;
+  frame_clock_client_init(&state->clock, animation_clock_step, state, NULL, 1);
   state->layer = NULL;
-  
-  // Seed random with current time
-  time_t t = time(NULL);
-  s_random_seed = (uint32_t)t;
+  state->seed = 0;
+  state->schedule = NULL;
+  state->field.masks[0] = state->field.masks[1] = NULL;
+  state->schedule_cols = 0;
+  state->schedule_rows = 0;
+  state->start_ms = 0;
+  state->last_ms = 0;
+  state->frames = 0;
+  state->dropped = 0;
+  state->detail = DETAIL_FULL;
+}
+
+void animations_set_seed(uint32_t seed) {
+  s_fixed_seed = seed;
 }
 
-void animations_start_load(AnimationState *state, AnimationType type) {
-  if (state->timer) {
-    app_timer_cancel(state->timer);
+// Per-cell schedule builder for the animation type, NULL if it has none
+static ScheduleCellFunc prv_schedule_func(AnimationType type) {
+  switch (type) {
+    case ANIM_WAVE_FILL:
+      return sideload_schedule_cell;
+    case ANIM_RANDOM_POP:
+      return random_schedule_cell;
+    default:
+      return NULL;
   }
+}
+
+// Hash every visible cell once up front so frames only read one byte per
+// cell. Without memory for the table the draw functions hash on the fly.
+static void prv_build_schedule(AnimationState *state, int grid_cols, int grid_rows,
+                               const GridSpan *spans) {
+  ScheduleCellFunc func = prv_schedule_func(state->type);
+  if (!func || grid_cols <= 0 || grid_rows <= 0 || grid_cols > 255 || grid_rows > 255) return;
+  
+  state->schedule = calloc(grid_cols * grid_rows, 1);
+  if (!state->schedule) return;
+  state->schedule_cols = (uint8_t)grid_cols;
+  state->schedule_rows = (uint8_t)grid_rows;
+  
+  for (int r = 0; r < grid_rows; r++) {
+    GridSpan span = grid_row_span(spans, r, grid_cols);
+    uint8_t *row = state->schedule + r * grid_cols;
+    for (int c = span.first; c <= span.last; c++) {
+      row[c] = func(state->seed, r, c);
+    }
+  }
+}
+
+// Render the wave fill field; false if it does not fit in memory
+static bool prv_build_field(AnimationState *state, int grid_cols, int grid_rows,
+                            const GridSpan *spans) {
+  if (grid_cols <= 0 || grid_rows <= 0 || grid_cols > 255 || grid_rows > 255) return false;
+  if (!sideload_field_create(&state->field, state->seed, grid_cols, grid_rows, spans)) return false;
+  state->schedule_cols = (uint8_t)grid_cols;
+  state->schedule_rows = (uint8_t)grid_rows;
+  return true;
+}
+
+static void prv_free_schedule(AnimationState *state) {
+  free(state->schedule);
+  state->schedule = NULL;
+  sideload_field_destroy(&state->field);
+  state->schedule_cols = 0;
+  state->schedule_rows = 0;
+}
+
+void animations_start_load(AnimationState *state, AnimationType type,
+                           int grid_cols, int grid_rows, const GridSpan *spans) {
+  frame_clock_stop(&state->clock);
+  prv_free_schedule(state);
   
   state->type = type;
-  state->progress = 0.0f;
-  state->fade = 1.0f;
+  timeline_start(&state->timeline, DURATION_MS);
+  state->progress = 0;
+  state->fade = FIXED_ONE;
   state->active = true;
+  state->start_ms = wall_clock_ms();
+  state->last_ms = state->start_ms;
+  state->frames = 0;
+  state->dropped = 0;
+  state->detail = DETAIL_FULL;
   
-  // Reseed random for new animation
-  time_t t = time(NULL);
-  s_random_seed = (uint32_t)t + (random_next() & 0xFF);
+  // New cell pattern for every run unless a seed is fixed
+  state->seed = s_fixed_seed ? s_fixed_seed : (uint32_t)time(NULL);
+  // Wave fill draws from its field; the schedule is the fallback without
+  // memory for it
+  if (type != ANIM_WAVE_FILL || !prv_build_field(state, grid_cols, grid_rows, spans)) {
+    prv_build_schedule(state, grid_cols, grid_rows, spans);
+  }
   
-  // Start animation timer (30 FPS)
-  state->timer = app_timer_register(33, animation_timer_callback, state);
+  // Step on every frame clock tick (30 FPS)
+  frame_clock_client_init(&state->clock, animation_clock_step, state, state->layer, 1);
+  frame_clock_start(&state->clock);
 }
 
 void animations_stop(AnimationState *state) {
-  if (state->timer) {
-    app_timer_cancel(state->timer);
-    state->timer = NULL;
+  frame_clock_stop(&state->clock);
+  prv_free_schedule(state);
+  if (state->active && state->last_ms != state->start_ms) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Load animation: %d fps, %d frames, %d dropped, detail %d",
+            animations_fps(state), state->frames, state->dropped, state->detail);
   }
   state->active = false;
 }
 
+// Advance the timeline by the time that actually passed since the last step
+static void prv_step(AnimationState *state) {
+  uint32_t now = wall_clock_ms();
+  uint32_t elapsed = now - state->last_ms;
+  state->last_ms = now;
+  if (elapsed >= 2 * FRAME_MS) {
+    state->dropped += elapsed / FRAME_MS - 1;
+  }
+  timeline_advance(&state->timeline, elapsed < DURATION_MS ? (uint16_t)elapsed : DURATION_MS);
+}
+
 void animations_update(AnimationState *state) {
   if (!state->active) return;
   
@@ -62,15 +150,11 @@ void animations_update(AnimationState *state) {
     case ANIM_RANDOM_POP:
     case ANIM_MATRIX:
       // All animations use same timing: 0.0 to 0.7 (animation), 0.7 to 1.0 (fade out)
-      state->progress += 0.02f;  // ~1.5 seconds total
-      
-      if (state->progress >= 0.7f) {
-        // Start fade out
-        state->fade = 1.0f - ((state->progress - 0.7f) / 0.3f);
-        if (state->fade < 0.0f) state->fade = 0.0f;
-      }
+      prv_step(state);  // ~1.5 seconds total
+      state->progress = timeline_progress(&state->timeline);
+      state->fade = FIXED_ONE - timeline_segment(state->progress, FIXED(0.7), FIXED_ONE);
       
-      if (state->progress >= 1.0f) {
+      if (timeline_done(&state->timeline)) {
         animations_stop(state);
       }
       break;
@@ -81,77 +165,89 @@ void animations_update(AnimationState *state) {
   }
 }
 
-static void animation_timer_callback(void *data) {
+// The frame clock marks the layer dirty after each step
+static bool animation_clock_step(void *data) {
   AnimationState *state = (AnimationState *)data;
   animations_update(state);
-  
-  // Trigger redraw
-  if (state->layer) {
-    layer_mark_dirty(state->layer);
-  }
-  
-  if (state->active) {
-    // Schedule next frame
-    state->timer = app_timer_register(33, animation_timer_callback, state);
-  }
+  return state->active;
+}
+
+// The schedule only applies to the grid it was built for
+static const uint8_t *prv_schedule(AnimationState *state, int grid_cols, int grid_rows) {
+  if (state->schedule_cols != grid_cols || state->schedule_rows != grid_rows) return NULL;
+  return state->schedule;
+}
+
+static const SideloadField *prv_field(AnimationState *state, int grid_cols, int grid_rows) {
+  if (state->schedule_cols != grid_cols || state->schedule_rows != grid_rows) return NULL;
+  return &state->field;
 }
 
 // Draw wave fill animation
-static void draw_wave_fill(GContext *ctx, AnimationState *state,
-                          int grid_cols, int grid_rows,
+static void draw_wave_fill(GridCanvas *canvas, AnimationState *state,
+                          int grid_cols, int grid_rows, const GridSpan *spans,
                           int grid_offset_x, int grid_offset_y,
-                          int cell_size, int full_size, int full_offset,
-                          int partial_size, int partial_offset,
                           GColor fg_color, GColor secondary_color) {
   // Use sideload animation
-  draw_sideload_animation(ctx, state->progress, state->fade,
-                         grid_cols, grid_rows,
+  draw_sideload_animation(canvas, state->progress, state->fade, state->seed,
+                         prv_field(state, grid_cols, grid_rows),
+                         prv_schedule(state, grid_cols, grid_rows), state->detail,
+                         grid_cols, grid_rows, spans,
                          grid_offset_x, grid_offset_y,
-                         cell_size, full_size, full_offset,
-                         partial_size, partial_offset,
                          fg_color, secondary_color);
 }
 
-void animations_draw(GContext *ctx, AnimationState *state,
-                    int grid_cols, int grid_rows,
+void animations_draw(GridCanvas *canvas, AnimationState *state,
+                    int grid_cols, int grid_rows, const GridSpan *spans,
                     int grid_offset_x, int grid_offset_y,
-                    int cell_size, int full_size, int full_offset,
-                    int partial_size, int partial_offset,
                     GColor fg_color, GColor secondary_color) {
   if (!state->active) return;
+  uint32_t start = wall_clock_ms();
   
   switch (state->type) {
     case ANIM_WAVE_FILL:
-      draw_wave_fill(ctx, state, grid_cols, grid_rows,
+      draw_wave_fill(canvas, state, grid_cols, grid_rows, spans,
                     grid_offset_x, grid_offset_y,
-                    cell_size, full_size, full_offset,
-                    partial_size, partial_offset,
                     fg_color, secondary_color);
       break;
     
     case ANIM_RANDOM_POP:
-      draw_random_animation(ctx, state->progress, state->fade,
-                           grid_cols, grid_rows,
+      draw_random_animation(canvas, state->progress, state->fade, state->seed,
+                           prv_schedule(state, grid_cols, grid_rows), state->detail,
+                           grid_cols, grid_rows, spans,
                            grid_offset_x, grid_offset_y,
-                           cell_size, full_size, full_offset,
-                           partial_size, partial_offset,
                            fg_color, secondary_color);
       break;
     
     case ANIM_MATRIX:
-      draw_matrix_animation(ctx, state->progress, state->fade,
-                           grid_cols, grid_rows,
+      draw_matrix_animation(canvas, state->progress, state->fade, state->seed,
+                           state->detail,
+                           grid_cols, grid_rows, spans,
                            grid_offset_x, grid_offset_y,
-                           cell_size, full_size, full_offset,
-                           partial_size, partial_offset,
                            fg_color, secondary_color);
       break;
       
     default:
       break;
   }
+  
+  // Include drawing the queued cells in the frame's cost
+  grid_canvas_flush(canvas);
+  uint32_t cost = wall_clock_ms() - start;
+  if (cost > FRAME_BUDGET_MS && state->detail < DETAIL_MIN) {
+    state->detail++;
+  } else if (cost < FRAME_BUDGET_MS / 2 && state->detail > DETAIL_FULL) {
+    state->detail--;
+  }
+  state->frames++;
 }
 
 bool animations_is_active(AnimationState *state) {
   return state->active;
 }
+
+int animations_fps(AnimationState *state) {
+  uint32_t elapsed = state->last_ms - state->start_ms;
+  if (elapsed == 0) return 0;
+  return (int)(state->frames * 1000u / elapsed);
+}
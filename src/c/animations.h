@@ -1,5 +1,9 @@
 #pragma once
 #include <pebble.h>
+#include "grid.h"
+#include "timeline.h"
+#include "frame_clock.h"
+#include "animations/sideload.h"
 
 // Animation types
 typedef enum {
@@ -13,32 +17,53 @@ typedef enum {
 // Animation state
 typedef struct {
   AnimationType type;
-  float progress;       // 0.0 to 1.0
-  float fade;           // 0.0 to 1.0 for fade out
+  Timeline timeline;
+  fixed_t progress;     // 0 to FIXED_ONE
+  fixed_t fade;         // FIXED_ONE to 0 while fading out
+  uint32_t seed;        // Per-run seed for the cell hashes
+  uint8_t *schedule;    // Packed per-cell schedule (see animations/schedule.h), or NULL
+  SideloadField field;  // Wave fill cells pre-rendered per color, or NULL masks
+  uint8_t schedule_cols;  // Grid the schedule or field was built for
+  uint8_t schedule_rows;
+  uint32_t start_ms;    // Wall clock when the run started
+  uint32_t last_ms;     // Wall clock of the last timeline step
+  uint16_t frames;      // Frames drawn this run
+  uint16_t dropped;     // Frame slots skipped because a step came late
+  uint8_t detail;       // DETAIL_* level, lowered when frames run over budget
   bool active;
-  AppTimer *timer;
+  FrameClockClient clock;
   Layer *layer;         // Layer to mark dirty
 } AnimationState;
 
 // Initialize animation system
 void animations_init(AnimationState *state);
 
-// Start a load animation
-void animations_start_load(AnimationState *state, AnimationType type);
+// Use a fixed seed for every following run (e.g. for reproducible
+// benchmarks); 0 goes back to seeding each run from the clock
+void animations_set_seed(uint32_t seed);
+
+// Start a load animation over a grid_cols x grid_rows grid. spans limits
+// each row to its visible cells (see grid_row_span); NULL for the whole grid.
+void animations_start_load(AnimationState *state, AnimationType type,
+                           int grid_cols, int grid_rows, const GridSpan *spans);
 
 // Stop current animation
 void animations_stop(AnimationState *state);
 
-// Update animation (call from timer)
+// Advance the animation by the wall-clock time since the last step (called
+// from the frame clock). Late steps jump ahead, so slow frames are dropped rather than
+// stretching the animation.
 void animations_update(AnimationState *state);
 
-// Draw current animation
-void animations_draw(GContext *ctx, AnimationState *state, 
-                     int grid_cols, int grid_rows, 
+// Draw current animation. Times the frame, including drawing the queued
+// cells, and lowers the detail level while frames run over budget.
+void animations_draw(GridCanvas *canvas, AnimationState *state, 
+                     int grid_cols, int grid_rows, const GridSpan *spans,
                      int grid_offset_x, int grid_offset_y,
-                     int cell_size, int full_size, int full_offset,
-                     int partial_size, int partial_offset,
                      GColor fg_color, GColor secondary_color);
 
 // Check if animation is active
 bool animations_is_active(AnimationState *state);
+
+// Frames per second achieved by the current or last run
+int animations_fps(AnimationState *state);
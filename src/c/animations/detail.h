@@ -0,0 +1,15 @@
+#pragma once
+#include <pebble.h>
+#include "../grid.h"
+
+// Detail levels for the load animations, lowered by the frame pacer when
+// drawing a frame runs over its budget
+#define DETAIL_FULL 0
+#define DETAIL_NO_PARTIAL 1  // Skip partial cells
+#define DETAIL_COARSE 2      // Also skip every other cell (checkerboard)
+#define DETAIL_MIN DETAIL_COARSE
+
+static inline bool detail_skip_cell(uint8_t detail, uint8_t state, int row, int col) {
+  if (detail >= DETAIL_NO_PARTIAL && state == CELL_PARTIAL) return true;
+  return detail >= DETAIL_COARSE && ((row + col) & 1);
+}
@@ -1,88 +1,78 @@
 #include "matrix.h"
+#include "../hash.h"
 #include <stdlib.h>
 
-// Random seed for animation
-static uint32_t s_random_seed = 0;
-
-// Simple pseudo-random number generator
-static uint32_t random_next(void) {
-  s_random_seed = (s_random_seed * 1103515245 + 12345) & 0x7fffffff;
-  return s_random_seed;
-}
-
-// Initialize seed
-void matrix_init_seed(uint32_t seed) {
-  s_random_seed = seed;
-}
+// Independent hash streams per cell
+enum {
+  STREAM_START,
+  STREAM_SPEED,
+};
 
 // Draw matrix falling animation
 // Columns of cells fall down with bright heads and fading trails
-void draw_matrix_animation(GContext *ctx, float progress, float fade,
-                           int grid_cols, int grid_rows,
+void draw_matrix_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                           uint8_t detail,
+                           int grid_cols, int grid_rows, const GridSpan *spans,
                            int grid_offset_x, int grid_offset_y,
-                           int cell_size, int full_size, int full_offset,
-                           int partial_size, int partial_offset,
                            GColor fg_color, GColor secondary_color) {
   // Animation over 0.0 to 0.7, then fade 0.7 to 1.0
   
-  uint32_t saved_seed = s_random_seed;
-  
   // Each column has its own falling stream
   for (int c = 0; c < grid_cols; c++) {
-    // Generate deterministic random values for this column
-    s_random_seed = (uint32_t)(c * 2654435761U + saved_seed);
-    uint32_t rand_val = random_next();
-    uint32_t rand_val2 = random_next();
+    // Deterministic random values for this column
+    uint32_t rand_val = hash(seed, 0, c, STREAM_START);
+    uint32_t rand_val2 = hash(seed, 0, c, STREAM_SPEED);
     
     // Column start time (stagger between 0.0 and 0.2)
-    float col_start = (rand_val % 200) / 1000.0f;
+    fixed_t col_start = (fixed_t)(rand_val % 200) * FIXED_ONE / 1000;
+    if (progress < col_start) continue;
     
-    // Column speed (some fall faster than others)
-    float col_speed = 0.8f + ((rand_val2 % 40) / 100.0f); // 0.8 to 1.2
+    // Column speed in hundredths (some fall faster than others)
+    int col_speed = 80 + (rand_val2 % 40); // 0.8 to 1.2
     
     // Calculate column progress (0.0 to 0.7 for movement phase)
-    float col_progress = (progress - col_start) * col_speed;
-    if (col_progress < 0.0f) continue;
+    fixed_t col_progress = (progress - col_start) * col_speed / 100;
     
     // Head position moves from -1 to grid_rows
     // At col_progress = 0.7, head should be at bottom (grid_rows - 1)
-    float head_row = (col_progress / 0.7f) * grid_rows - 1.0f;
+    fixed_t head_row = col_progress * grid_rows * 10 / 7 - FIXED_ONE;
     
     // Calculate per-column fade
-    float col_fade = fade; // Start with global fade
-    if (head_row >= grid_rows - 1) {
-      // Head has reached bottom, start fading this column
-      float time_at_bottom = col_progress - (0.7f * (grid_rows - 1 + 1) / grid_rows);
-      float col_fade_progress = time_at_bottom / 0.3f; // Fade over 0.3 seconds
-      col_fade = 1.0f - col_fade_progress;
-      if (col_fade < 0.0f) col_fade = 0.0f;
+    fixed_t col_fade = fade; // Start with global fade
+    if (head_row >= fixed_from_int(grid_rows - 1)) {
+      // Head has reached bottom, start fading this column over 0.3
+      col_fade = FIXED_ONE - timeline_segment(col_progress, FIXED(0.7), FIXED(1.0));
       
       // Skip this column if fully faded
-      if (col_fade < 0.1f) continue;
+      if (col_fade < FIXED(0.1)) continue;
       
       // Clamp head to grid bounds
-      head_row = grid_rows - 1;
+      head_row = fixed_from_int(grid_rows - 1);
     }
     
     // Draw all cells from top (0) to head position
     for (int r = 0; r < grid_rows; r++) {
+      GridSpan span = grid_row_span(spans, r, grid_cols);
+      if (c < span.first || c > span.last) continue;
+      fixed_t row = fixed_from_int(r);
+      
       // Only draw cells at or above the head
-      if (r > head_row + 0.5f) continue;
+      if (row > head_row + FIXED_ONE / 2) continue;
       
       // Apply per-column fade
-      if (col_fade < 0.3f) continue;
+      if (col_fade < FIXED(0.3)) continue;
       
-      int cell_state;
+      uint8_t cell_state;
       bool use_secondary = false;
       
       // Check if this is the head position
-      if (r >= head_row - 0.5f && r <= head_row + 0.5f) {
+      if (row >= head_row - FIXED_ONE / 2 && row <= head_row + FIXED_ONE / 2) {
         // The bright head - full cell, foreground color
         cell_state = 2; // CELL_FULL
         use_secondary = false;
       } else {
         // Trail above the head
-        int trail_pos = (int)(head_row - r);
+        int trail_pos = fixed_floor(head_row - row);
         
         // Alternate cell states: full, partial, full, partial...
         if (trail_pos % 2 == 0) {
@@ -95,22 +85,12 @@ void draw_matrix_animation(GContext *ctx, float progress, float fade,
         use_secondary = (trail_pos % 2 == 0);
       }
       
-      // Set color
-      GColor color = use_secondary ? secondary_color : fg_color;
-      graphics_context_set_fill_color(ctx, color);
-      
-      int x = grid_offset_x + c * cell_size;
-      int y = grid_offset_y + r * cell_size;
+      if (detail_skip_cell(detail, cell_state, r, c)) continue;
       
-      if (cell_state == 2) {
-        // CELL_FULL
-        graphics_fill_rect(ctx, GRect(x + full_offset, y + full_offset, full_size, full_size), 0, GCornerNone);
-      } else {
-        // CELL_PARTIAL
-        graphics_fill_rect(ctx, GRect(x + partial_offset, y + partial_offset, partial_size, partial_size), 0, GCornerNone);
-      }
+      GColor color = use_secondary ? secondary_color : fg_color;
+      grid_canvas_cell(canvas, grid_offset_x + c * CELL_SIZE, grid_offset_y + r * CELL_SIZE,
+                       cell_state, color);
     }
   }
   
-  s_random_seed = saved_seed;
 }
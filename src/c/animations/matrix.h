@@ -1,10 +1,12 @@
 #pragma once
 #include <pebble.h>
+#include "../grid.h"
+#include "../timeline.h"
+#include "detail.h"
 
 // Draw matrix falling animation
-void draw_matrix_animation(GContext *ctx, float progress, float fade,
-                           int grid_cols, int grid_rows,
+void draw_matrix_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                           uint8_t detail,
+                           int grid_cols, int grid_rows, const GridSpan *spans,
                            int grid_offset_x, int grid_offset_y,
-                           int cell_size, int full_size, int full_offset,
-                           int partial_size, int partial_offset,
                            GColor fg_color, GColor secondary_color);
@@ -1,86 +1,68 @@
 #include "random.h"
+#include "../hash.h"
 #include <stdlib.h>
 
-// Random seed for animation
-static uint32_t s_random_seed = 0;
+// Independent hash streams per cell
+enum {
+  STREAM_START,
+  STREAM_COLOR,
+};
 
-// Simple pseudo-random number generator
-static uint32_t random_next(void) {
-  s_random_seed = (s_random_seed * 1103515245 + 12345) & 0x7fffffff;
-  return s_random_seed;
-}
-
-// Initialize seed
-void random_init_seed(uint32_t seed) {
-  s_random_seed = seed;
+uint8_t random_schedule_cell(uint32_t seed, int row, int col) {
+  // Deterministic random values for this cell
+  uint32_t rand_val = hash(seed, row, col, STREAM_START);
+  uint32_t rand_val2 = hash(seed, row, col, STREAM_COLOR);
+  
+  // Each cell has a random start time (0.0 to 0.5)
+  uint8_t start = (uint8_t)(rand_val % (SCHEDULE_START_MAX + 1));
+  
+  // Determine color (55% foreground, 45% secondary)
+  bool use_secondary = (rand_val2 % 100) < 45;
+  return schedule_pack(CELL_EMPTY, use_secondary, start);
 }
 
 // Draw random pop animation
 // Cells appear randomly, turn full -> partial -> disappear
-void draw_random_animation(GContext *ctx, float progress, float fade,
-                           int grid_cols, int grid_rows,
+void draw_random_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                           const uint8_t *schedule, uint8_t detail,
+                           int grid_cols, int grid_rows, const GridSpan *spans,
                            int grid_offset_x, int grid_offset_y,
-                           int cell_size, int full_size, int full_offset,
-                           int partial_size, int partial_offset,
                            GColor fg_color, GColor secondary_color) {
   // Animation phases over 1.5 seconds:
   // 0.0 - 0.7: Cells appear and transition (full -> partial -> disappear)
   // 0.7 - 1.0: Fade out
-  
-  uint32_t saved_seed = s_random_seed;
+  if (fade < FIXED(0.3)) return;
   
   for (int r = 0; r < grid_rows; r++) {
-    for (int c = 0; c < grid_cols; c++) {
-      // Generate deterministic random value for this cell
-      s_random_seed = (uint32_t)((r * 2654435761U) ^ (c * 2246822519U) ^ saved_seed);
-      uint32_t rand_val = random_next();
-      uint32_t rand_val2 = random_next();
-      
-      // Each cell has a random start time (0.0 to 0.5)
-      float cell_start = (rand_val % 500) / 1000.0f;
+    GridSpan span = grid_row_span(spans, r, grid_cols);
+    for (int c = span.first; c <= span.last; c++) {
+      uint8_t entry = schedule ? schedule[r * grid_cols + c] : random_schedule_cell(seed, r, c);
       
       // Cell duration: 0.5 seconds (full -> partial -> disappear)
-      float cell_duration = 0.5f;
-      float cell_progress = (progress - cell_start) / cell_duration;
+      fixed_t cell_progress = (progress - schedule_start(entry)) * 2;
       
       // Skip if cell hasn't started yet or already finished
-      if (cell_progress < 0.0f || cell_progress > 1.0f) continue;
-      
-      // Apply fade
-      if (fade < 0.3f) continue;
+      if (cell_progress < 0 || cell_progress > FIXED_ONE) continue;
       
       // Determine cell state based on progress
       // 0.0 - 0.33: Full
       // 0.33 - 0.66: Partial
       // 0.66 - 1.0: Disappear
-      int cell_state;
-      if (cell_progress < 0.33f) {
-        cell_state = 2; // CELL_FULL
-      } else if (cell_progress < 0.66f) {
-        cell_state = 1; // CELL_PARTIAL
+      uint8_t cell_state;
+      if (cell_progress < FIXED(0.33)) {
+        cell_state = CELL_FULL;
+      } else if (cell_progress < FIXED(0.66)) {
+        cell_state = CELL_PARTIAL;
       } else {
         continue; // Disappeared
       }
       
-      // Determine color (55% foreground, 45% secondary)
-      bool use_secondary = (rand_val2 % 100) < 45;
-      
-      // Set color
-      GColor color = use_secondary ? secondary_color : fg_color;
-      graphics_context_set_fill_color(ctx, color);
-      
-      int x = grid_offset_x + c * cell_size;
-      int y = grid_offset_y + r * cell_size;
+      // Cells dropped at lower detail
+      if (detail_skip_cell(detail, cell_state, r, c)) continue;
       
-      if (cell_state == 2) {
-        // CELL_FULL
-        graphics_fill_rect(ctx, GRect(x + full_offset, y + full_offset, full_size, full_size), 0, GCornerNone);
-      } else {
-        // CELL_PARTIAL
-        graphics_fill_rect(ctx, GRect(x + partial_offset, y + partial_offset, partial_size, partial_size), 0, GCornerNone);
-      }
+      GColor color = schedule_secondary(entry) ? secondary_color : fg_color;
+      grid_canvas_cell(canvas, grid_offset_x + c * CELL_SIZE, grid_offset_y + r * CELL_SIZE,
+                       cell_state, color);
     }
   }
-  
-  s_random_seed = saved_seed;
 }
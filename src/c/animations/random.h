@@ -1,10 +1,16 @@
 #pragma once
 #include <pebble.h>
+#include "../grid.h"
+#include "../timeline.h"
+#include "detail.h"
+#include "schedule.h"
+
+// Schedule entry for one random pop cell: start time and color
+uint8_t random_schedule_cell(uint32_t seed, int row, int col);
 
 // Draw random pop animation
-void draw_random_animation(GContext *ctx, float progress, float fade,
-                           int grid_cols, int grid_rows,
+void draw_random_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                           const uint8_t *schedule, uint8_t detail,
+                           int grid_cols, int grid_rows, const GridSpan *spans,
                            int grid_offset_x, int grid_offset_y,
-                           int cell_size, int full_size, int full_offset,
-                           int partial_size, int partial_offset,
                            GColor fg_color, GColor secondary_color);
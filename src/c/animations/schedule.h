@@ -0,0 +1,30 @@
+#pragma once
+#include <pebble.h>
+#include "../timeline.h"
+
+// Per-cell schedule entry, one byte per grid cell, built once when a load
+// animation starts: bits 0-1 cell state, bit 2 secondary color, bits 3-7
+// start time in 1/64 of the animation's progress (0 to 31/64)
+#define SCHEDULE_STATE_MASK 0x03
+#define SCHEDULE_SECONDARY 0x04
+#define SCHEDULE_START_SHIFT 3
+#define SCHEDULE_START_MAX 31
+
+static inline uint8_t schedule_pack(uint8_t state, bool secondary, uint8_t start) {
+  return (uint8_t)((start << SCHEDULE_START_SHIFT) | (secondary ? SCHEDULE_SECONDARY : 0) | state);
+}
+
+static inline uint8_t schedule_state(uint8_t entry) {
+  return entry & SCHEDULE_STATE_MASK;
+}
+
+static inline bool schedule_secondary(uint8_t entry) {
+  return (entry & SCHEDULE_SECONDARY) != 0;
+}
+
+static inline fixed_t schedule_start(uint8_t entry) {
+  return (fixed_t)(entry >> SCHEDULE_START_SHIFT) * (FIXED_ONE / 64);
+}
+
+// Computes one cell's entry from the run's seed
+typedef uint8_t (*ScheduleCellFunc)(uint32_t seed, int row, int col);
@@ -1,83 +1,114 @@
 #include "sideload.h"
+#include "../hash.h"
 #include <stdlib.h>
 
-// Random seed for animation
-static uint32_t s_random_seed = 0;
+// Independent hash streams per cell
+enum {
+  STREAM_STATE,
+  STREAM_COLOR,
+};
 
-// Simple pseudo-random number generator
-static uint32_t random_next(void) {
-  s_random_seed = (s_random_seed * 1103515245 + 12345) & 0x7fffffff;
-  return s_random_seed;
+uint8_t sideload_schedule_cell(uint32_t seed, int row, int col) {
+  // Deterministic random values for this cell
+  uint32_t rand_val = hash(seed, row, col, STREAM_STATE);
+  uint32_t rand_val2 = hash(seed, row, col, STREAM_COLOR);
+  
+  // Determine cell state with more randomness (15% empty, 35% partial, 50% full)
+  uint8_t cell_state;
+  int state_rand = rand_val % 100;
+  if (state_rand < 15) {
+    cell_state = CELL_EMPTY;
+  } else if (state_rand < 50) {
+    cell_state = CELL_PARTIAL;
+  } else {
+    cell_state = CELL_FULL;
+  }
+  
+  // Determine color with more variation (55% foreground, 45% secondary)
+  bool use_secondary = (rand_val2 % 100) < 45;
+  return schedule_pack(cell_state, use_secondary, 0);
+}
+
+bool sideload_field_create(SideloadField *field, uint32_t seed,
+                           int grid_cols, int grid_rows, const GridSpan *spans) {
+  GSize size = GSize(grid_cols * CELL_SIZE, grid_rows * CELL_SIZE);
+  field->masks[0] = glyph_mask_create(size);
+  field->masks[1] = field->masks[0] ? glyph_mask_create(size) : NULL;
+  if (!field->masks[1]) {
+    sideload_field_destroy(field);
+    return false;
+  }
+  
+  for (int r = 0; r < grid_rows; r++) {
+    GridSpan span = grid_row_span(spans, r, grid_cols);
+    for (int c = span.first; c <= span.last; c++) {
+      uint8_t entry = sideload_schedule_cell(seed, r, c);
+      glyph_mask_stamp(field->masks[schedule_secondary(entry)], c * CELL_SIZE, r * CELL_SIZE,
+                       schedule_state(entry));
+    }
+  }
+  return true;
+}
+
+void sideload_field_destroy(SideloadField *field) {
+  for (int i = 0; i < 2; i++) {
+    if (field->masks[i]) gbitmap_destroy(field->masks[i]);
+    field->masks[i] = NULL;
+  }
 }
 
-// Initialize seed
-void sideload_init_seed(uint32_t seed) {
-  s_random_seed = seed;
+// Blit the revealed rows of both masks; cells never overlap, so the order
+// does not matter
+static void prv_draw_field(GridCanvas *canvas, const SideloadField *field, int rows,
+                           int grid_cols, int grid_offset_x, int grid_offset_y,
+                           GColor fg_color, GColor secondary_color) {
+  GRect revealed = GRect(0, 0, grid_cols * CELL_SIZE, rows * CELL_SIZE);
+  GRect rect = GRect(grid_offset_x, grid_offset_y, revealed.size.w, revealed.size.h);
+  for (int i = 0; i < 2; i++) {
+    gbitmap_set_bounds(field->masks[i], revealed);
+    glyph_mask_draw(field->masks[i], canvas->ctx, rect, i ? secondary_color : fg_color);
+  }
 }
 
 // Draw wave fill animation (sideload effect)
-void draw_sideload_animation(GContext *ctx, float progress, float fade,
-                              int grid_cols, int grid_rows,
+void draw_sideload_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                              const SideloadField *field, const uint8_t *schedule, uint8_t detail,
+                              int grid_cols, int grid_rows, const GridSpan *spans,
                               int grid_offset_x, int grid_offset_y,
-                              int cell_size, int full_size, int full_offset,
-                              int partial_size, int partial_offset,
                               GColor fg_color, GColor secondary_color) {
+  // Apply fade to entire animation
+  if (fade < FIXED(0.3)) return;
+  
   // Wave sweeps from top to bottom
   // At progress 0.0, wave is at top (row -5)
   // At progress 0.7, wave is past bottom
-  float wave_row = progress * (grid_rows + 10) / 0.7f - 5.0f;
+  fixed_t wave_row = progress * (grid_rows + 10) * 10 / 7 - fixed_from_int(5);
+  int wave_end_row = fixed_floor(wave_row) + 5;
   
-  // Random cell generation - use consistent seed per cell
-  uint32_t saved_seed = s_random_seed;
+  // Only rows touched by the wave are drawn
+  int rows = (wave_end_row + 1 < grid_rows) ? wave_end_row + 1 : grid_rows;
+  if (rows <= 0) return;
   
-  for (int r = 0; r < grid_rows; r++) {
-    for (int c = 0; c < grid_cols; c++) {
-      // Check if this row has been touched by the wave
-      bool touched_by_wave = (r <= wave_row + 5);
-      
-      if (!touched_by_wave) continue;
-      
-      // Generate deterministic "random" value for this cell with better mixing
-      s_random_seed = (uint32_t)((r * 2654435761U) ^ (c * 2246822519U) ^ saved_seed);
-      uint32_t rand_val = random_next();
-      uint32_t rand_val2 = random_next();
-      
-      // Determine cell state with more randomness (15% empty, 35% partial, 50% full)
-      int cell_state;
-      int state_rand = rand_val % 100;
-      if (state_rand < 15) {
-        cell_state = 0; // CELL_EMPTY
-      } else if (state_rand < 50) {
-        cell_state = 1; // CELL_PARTIAL
-      } else {
-        cell_state = 2; // CELL_FULL
-      }
-      
-      // Skip empty cells
-      if (cell_state == 0) continue;
-      
-      // Apply fade to entire animation
-      if (fade < 0.3f) continue;
-      
-      // Determine color with more variation (55% foreground, 45% secondary)
-      bool use_secondary = (rand_val2 % 100) < 45;
-      
-      // Set color
-      GColor color = use_secondary ? secondary_color : fg_color;
-      graphics_context_set_fill_color(ctx, color);
+  // The field ignores the detail level: a blit is already cheaper than the
+  // fewest cells drawn one by one
+  if (field && field->masks[0]) {
+    prv_draw_field(canvas, field, rows, grid_cols, grid_offset_x, grid_offset_y,
+                   fg_color, secondary_color);
+    return;
+  }
+  
+  for (int r = 0; r < rows; r++) {
+    GridSpan span = grid_row_span(spans, r, grid_cols);
+    for (int c = span.first; c <= span.last; c++) {
+      uint8_t entry = schedule ? schedule[r * grid_cols + c] : sideload_schedule_cell(seed, r, c);
+      uint8_t cell_state = schedule_state(entry);
       
-      int x = grid_offset_x + c * cell_size;
-      int y = grid_offset_y + r * cell_size;
+      // Skip empty cells, and cells dropped at lower detail
+      if (cell_state == CELL_EMPTY || detail_skip_cell(detail, cell_state, r, c)) continue;
       
-      if (cell_state == 2) {
-        // CELL_FULL
-        graphics_fill_rect(ctx, GRect(x + full_offset, y + full_offset, full_size, full_size), 0, GCornerNone);
-      } else {
-        // CELL_PARTIAL
-        graphics_fill_rect(ctx, GRect(x + partial_offset, y + partial_offset, partial_size, partial_size), 0, GCornerNone);
-      }
+      GColor color = schedule_secondary(entry) ? secondary_color : fg_color;
+      grid_canvas_cell(canvas, grid_offset_x + c * CELL_SIZE, grid_offset_y + r * CELL_SIZE,
+                       cell_state, color);
     }
   }
-  
-  s_random_seed = saved_seed;
 }
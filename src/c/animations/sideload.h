@@ -1,10 +1,30 @@
 #pragma once
 #include <pebble.h>
+#include "../grid.h"
+#include "../glyphs.h"
+#include "../timeline.h"
+#include "detail.h"
+#include "schedule.h"
 
-// Draw wave fill animation (sideload effect)
-void draw_sideload_animation(GContext *ctx, float progress, float fade,
-                              int grid_cols, int grid_rows,
+// Schedule entry for one wave fill cell: state and color
+uint8_t sideload_schedule_cell(uint32_t seed, int row, int col);
+
+// The wave's cells never change once revealed, so the whole field is
+// rendered up front into one mask per color and each frame blits the rows
+// the wave has reached
+typedef struct {
+  GBitmap *masks[2];  // Foreground and secondary cells, NULL if not created
+} SideloadField;
+
+// Render the field for a grid; false (and nothing allocated) without memory
+bool sideload_field_create(SideloadField *field, uint32_t seed,
+                           int grid_cols, int grid_rows, const GridSpan *spans);
+void sideload_field_destroy(SideloadField *field);
+
+// Draw wave fill animation (sideload effect), from the field if it was
+// created, else cell by cell
+void draw_sideload_animation(GridCanvas *canvas, fixed_t progress, fixed_t fade, uint32_t seed,
+                              const SideloadField *field, const uint8_t *schedule, uint8_t detail,
+                              int grid_cols, int grid_rows, const GridSpan *spans,
                               int grid_offset_x, int grid_offset_y,
-                              int cell_size, int full_size, int full_offset,
-                              int partial_size, int partial_offset,
                               GColor fg_color, GColor secondary_color);
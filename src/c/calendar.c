@@ -0,0 +1,27 @@
+#include "calendar.h"
+
+// 53 weeks when the year starts on a Thursday, or on a Wednesday in a
+// leap year (equivalently: it ends on a Thursday, or the year before
+// ended on a Wednesday)
+static int prv_weeks_in_year(int year) {
+  int dec31 = (year + year / 4 - year / 100 + year / 400) % 7;  // 0=Sunday
+  int prev = year - 1;
+  int prev_dec31 = (prev + prev / 4 - prev / 100 + prev / 400) % 7;
+  return (dec31 == 4 || prev_dec31 == 3) ? 53 : 52;
+}
+
+uint8_t calendar_iso_week(const struct tm *t) {
+  int year = t->tm_year + 1900;
+  int day_of_week = t->tm_wday == 0 ? 7 : t->tm_wday;  // Monday=1, Sunday=7
+  int week = (t->tm_yday + 1 - day_of_week + 10) / 7;
+  
+  if (week < 1) {
+    // Last week of the previous year
+    return (uint8_t)prv_weeks_in_year(year - 1);
+  }
+  if (week > prv_weeks_in_year(year)) {
+    // First week of the next year
+    return 1;
+  }
+  return (uint8_t)week;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <pebble.h>
+
+// ISO 8601 week number (1-53) of a broken-down date. Weeks start on
+// Monday and week 1 holds the year's first Thursday, so early January can
+// fall in week 52 or 53 of the previous year and late December in week 1.
+uint8_t calendar_iso_week(const struct tm *t);
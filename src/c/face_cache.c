@@ -0,0 +1,74 @@
+#include "face_cache.h"
+#include <string.h>
+
+// Cache bytes needed for a framebuffer
+static size_t prv_size(GBitmap *frame_buffer) {
+  GRect bounds = gbitmap_get_bounds(frame_buffer);
+#ifdef PBL_ROUND
+  // Rows are stored at full width, but only their visible spans are copied
+  return (size_t)bounds.size.w * bounds.size.h;
+#else
+  return (size_t)gbitmap_get_bytes_per_row(frame_buffer) * bounds.size.h;
+#endif
+}
+
+static void prv_copy(FaceCache *cache, GBitmap *frame_buffer, bool save) {
+#ifdef PBL_ROUND
+  GRect bounds = gbitmap_get_bounds(frame_buffer);
+  for (int y = 0; y < bounds.size.h; y++) {
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, (uint16_t)y);
+    uint8_t *row = info.data + info.min_x;
+    uint8_t *cached = cache->pixels + y * bounds.size.w + info.min_x;
+    size_t size = info.max_x - info.min_x + 1;
+    if (save) {
+      memcpy(cached, row, size);
+    } else {
+      memcpy(row, cached, size);
+    }
+  }
+#else
+  uint8_t *data = gbitmap_get_data(frame_buffer);
+  if (save) {
+    memcpy(cache->pixels, data, cache->size);
+  } else {
+    memcpy(data, cache->pixels, cache->size);
+  }
+#endif
+}
+
+bool face_cache_save(FaceCache *cache, GContext *ctx) {
+  if (cache->alloc_failed) return false;
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) return false;
+  
+  size_t size = prv_size(frame_buffer);
+  if (cache->pixels && cache->size != size) face_cache_destroy(cache);
+  if (!cache->pixels) {
+    cache->pixels = malloc(size);
+    cache->size = cache->pixels ? size : 0;
+    cache->alloc_failed = !cache->pixels;
+  }
+  if (cache->pixels) {
+    prv_copy(cache, frame_buffer, true);
+    cache->valid = true;
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return cache->valid;
+}
+
+bool face_cache_restore(FaceCache *cache, GContext *ctx) {
+  if (!cache->valid) return false;
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) return false;
+  prv_copy(cache, frame_buffer, false);
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return true;
+}
+
+void face_cache_destroy(FaceCache *cache) {
+  free(cache->pixels);
+  cache->pixels = NULL;
+  cache->size = 0;
+  cache->valid = false;
+  cache->alloc_failed = false;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <pebble.h>
+
+// Copy of the finished static face (every widget below the seconds), so a
+// redraw where nothing changed restores it with one copy instead of drawing
+// every cell again. The buffer is allocated on the first save and is as big
+// as the framebuffer; without memory for it every frame draws in full, and
+// the allocation is not tried again until the layout changes.
+typedef struct {
+  uint8_t *pixels;    // NULL until the first save
+  size_t size;
+  bool valid;         // False once something on the face changed
+  bool alloc_failed;  // No memory for the buffer: saves are skipped
+} FaceCache;
+
+// Copy the framebuffer into the cache; false if it is unavailable
+bool face_cache_save(FaceCache *cache, GContext *ctx);
+
+// Copy the cached face into the framebuffer; false if there is none
+bool face_cache_restore(FaceCache *cache, GContext *ctx);
+
+// The face changed: the next frame has to draw it in full
+static inline void face_cache_invalidate(FaceCache *cache) {
+  cache->valid = false;
+}
+
+// The layout changed, which may have freed memory: try allocating again
+static inline void face_cache_retry(FaceCache *cache) {
+  cache->alloc_failed = false;
+}
+
+void face_cache_destroy(FaceCache *cache);
@@ -0,0 +1,127 @@
+#include "frame_clock.h"
+#include "profile.h"
+#include "wall_clock.h"
+
+static FrameClockClient *s_clients[FRAME_CLOCK_MAX_CLIENTS];
+static AppTimer *s_timer = NULL;
+static uint8_t s_pending_ticks = 0;  // Base ticks the pending timer covers
+static uint32_t s_armed_ms = 0;      // When the pending timer's period began
+
+static void prv_tick(void *data);
+
+// Whole base ticks of the pending timer's period already gone by; client
+// countdowns count from the start of that period
+static uint8_t prv_elapsed_ticks(void) {
+  if (!s_timer) return 0;
+  uint32_t ticks = (wall_clock_ms() - s_armed_ms) / FRAME_CLOCK_MS;
+  return ticks < s_pending_ticks ? (uint8_t)ticks : s_pending_ticks;
+}
+
+// Sleep until the next client is due rather than waking every base tick
+static void prv_schedule(void) {
+  uint8_t ticks = UINT8_MAX;
+  for (int i = 0; i < FRAME_CLOCK_MAX_CLIENTS; i++) {
+    if (s_clients[i] && s_clients[i]->countdown < ticks) {
+      ticks = s_clients[i]->countdown;
+    }
+  }
+  
+  if (ticks == UINT8_MAX) {
+    // Nothing is animating
+    if (s_timer) app_timer_cancel(s_timer);
+    s_timer = NULL;
+    s_pending_ticks = 0;
+    return;
+  }
+  
+  uint32_t delay_ms = ticks * FRAME_CLOCK_MS;
+  if (s_timer) {
+    if (ticks >= s_pending_ticks) return;
+    // Fire earlier, keeping the period's start so other clients stay in step
+    app_timer_cancel(s_timer);
+    uint32_t elapsed_ms = wall_clock_ms() - s_armed_ms;
+    delay_ms = elapsed_ms < delay_ms ? delay_ms - elapsed_ms : 1;
+  } else {
+    s_armed_ms = wall_clock_ms();
+  }
+  s_pending_ticks = ticks;
+  s_timer = app_timer_register(delay_ms, prv_tick, NULL);
+}
+
+static void prv_add_dirty(Layer **dirty, int *count, Layer *layer) {
+  if (!layer) return;
+  for (int i = 0; i < *count; i++) {
+    if (dirty[i] == layer) return;
+  }
+  dirty[(*count)++] = layer;
+}
+
+static void prv_tick(void *data) {
+  PROFILE_WAKEUP();
+  uint8_t ticks = s_pending_ticks;
+  s_timer = NULL;
+  s_pending_ticks = 0;
+  
+  Layer *dirty[FRAME_CLOCK_MAX_CLIENTS];
+  int dirty_count = 0;
+  for (int i = 0; i < FRAME_CLOCK_MAX_CLIENTS; i++) {
+    FrameClockClient *client = s_clients[i];
+    if (!client) continue;
+    
+    client->countdown = client->countdown > ticks ? client->countdown - ticks : 0;
+    if (client->countdown > 0) continue;
+    client->countdown = client->divider;
+    
+    if (!client->handler(client->context)) {
+      frame_clock_stop(client);
+    }
+    prv_add_dirty(dirty, &dirty_count, client->layer);
+  }
+  
+  for (int i = 0; i < dirty_count; i++) {
+    layer_mark_dirty(dirty[i]);
+  }
+  prv_schedule();
+}
+
+void frame_clock_client_init(FrameClockClient *client, FrameClockHandler handler,
+                             void *context, Layer *layer, uint8_t divider) {
+  client->handler = handler;
+  client->context = context;
+  client->layer = layer;
+  client->divider = divider > 0 ? divider : 1;
+  client->countdown = 0;
+  client->active = false;
+}
+
+void frame_clock_start(FrameClockClient *client) {
+  uint32_t countdown = (uint32_t)client->divider + prv_elapsed_ticks();
+  client->countdown = countdown < UINT8_MAX ? (uint8_t)countdown : UINT8_MAX - 1;
+  if (!client->active) {
+    for (int i = 0; i < FRAME_CLOCK_MAX_CLIENTS; i++) {
+      if (!s_clients[i]) {
+        s_clients[i] = client;
+        client->active = true;
+        break;
+      }
+    }
+  }
+  prv_schedule();
+}
+
+void frame_clock_stop(FrameClockClient *client) {
+  if (!client->active) return;
+  for (int i = 0; i < FRAME_CLOCK_MAX_CLIENTS; i++) {
+    if (s_clients[i] == client) {
+      s_clients[i] = NULL;
+    }
+  }
+  client->active = false;
+  
+  // From inside prv_tick the timer is rescheduled once all clients ran
+  if (s_timer) prv_schedule();
+}
+
+bool frame_clock_is_active(const FrameClockClient *client) {
+  return client->active;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <pebble.h>
+
+// One shared timer for everything that animates. Clients step every
+// `divider` base ticks; clients due on the same tick share one wakeup and
+// each dirty layer is marked once. The timer stops when no client is active.
+#define FRAME_CLOCK_MS 33
+#define FRAME_CLOCK_MAX_CLIENTS 4
+
+// Called on each of the client's steps; return false once finished
+typedef bool (*FrameClockHandler)(void *context);
+
+typedef struct {
+  FrameClockHandler handler;
+  void *context;
+  Layer *layer;        // Marked dirty after each step, or NULL
+  uint8_t divider;     // Step every `divider` base ticks
+  uint8_t countdown;   // Base ticks until the next step
+  bool active;
+} FrameClockClient;
+
+void frame_clock_client_init(FrameClockClient *client, FrameClockHandler handler,
+                             void *context, Layer *layer, uint8_t divider);
+
+// Start stepping the client (restarts its countdown if already active)
+void frame_clock_start(FrameClockClient *client);
+
+// Stop stepping the client; safe to call from its own handler
+void frame_clock_stop(FrameClockClient *client);
+
+bool frame_clock_is_active(const FrameClockClient *client);
@@ -0,0 +1,91 @@
+#include "glyphs.h"
+#include <string.h>
+
+static inline void prv_set_pixel(uint8_t *data, uint16_t bytes_per_row, int x, int y) {
+  uint8_t *byte = data + y * bytes_per_row + x / 8;
+#ifdef PBL_COLOR
+  *byte |= (uint8_t)(0x80 >> (x % 8));  // Palettized rows are MSB first
+#else
+  *byte |= (uint8_t)(1 << (x % 8));     // 1-bit rows are LSB first
+#endif
+}
+
+GBitmap *glyph_mask_create(GSize size) {
+  GBitmap *mask;
+#ifdef PBL_COLOR
+  // Index 0 is transparent, index 1 takes the draw color
+  GColor *palette = malloc(2 * sizeof(GColor));
+  if (!palette) return NULL;
+  palette[0] = GColorClear;
+  palette[1] = GColorWhite;
+  mask = gbitmap_create_blank_with_palette(size, GBitmapFormat1BitPalette, palette, true);
+  if (!mask) {
+    free(palette);
+    return NULL;
+  }
+#else
+  mask = gbitmap_create_blank(size, GBitmapFormat1Bit);
+  if (!mask) return NULL;
+#endif
+  memset(gbitmap_get_data(mask), 0, gbitmap_get_bytes_per_row(mask) * size.h);
+  return mask;
+}
+
+void glyph_mask_stamp(GBitmap *mask, int x, int y, uint8_t state) {
+  if (state == CELL_EMPTY) return;
+  uint8_t *data = gbitmap_get_data(mask);
+  uint16_t bytes_per_row = gbitmap_get_bytes_per_row(mask);
+  int offset = (state == CELL_FULL) ? FULL_OFFSET : PARTIAL_OFFSET;
+  int stamp = (state == CELL_FULL) ? FULL_SIZE : PARTIAL_SIZE;
+  for (int py = y + offset; py < y + offset + stamp; py++) {
+    for (int px = x + offset; px < x + offset + stamp; px++) {
+      prv_set_pixel(data, bytes_per_row, px, py);
+    }
+  }
+}
+
+void glyph_mask_draw(GBitmap *mask, GContext *ctx, GRect rect, GColor color) {
+#ifdef PBL_COLOR
+  gbitmap_get_palette(mask)[1] = color;
+  graphics_context_set_compositing_mode(ctx, GCompOpSet);
+#else
+  // Mask pixels are set bits: Or paints them white, Clear paints them black
+  graphics_context_set_compositing_mode(ctx, grid_color_is_white(color) ? GCompOpOr : GCompOpClear);
+#endif
+  graphics_draw_bitmap_in_rect(ctx, mask, rect);
+}
+
+bool glyph_set_create(GlyphSet *set, const uint8_t *patterns, uint8_t count,
+                      uint8_t cols, uint8_t rows) {
+  set->cols = cols;
+  set->rows = rows;
+  int width = cols * CELL_SIZE;
+  int height = rows * CELL_SIZE;
+  set->bitmap = glyph_mask_create(GSize(width * count, height));
+  if (!set->bitmap) return false;
+  
+  for (int glyph = 0; glyph < count; glyph++) {
+    const uint8_t *pattern = patterns + glyph * cols * rows;
+    for (int r = 0; r < rows; r++) {
+      for (int c = 0; c < cols; c++) {
+        glyph_mask_stamp(set->bitmap, glyph * width + c * CELL_SIZE, r * CELL_SIZE,
+                         pattern[r * cols + c]);
+      }
+    }
+  }
+  return true;
+}
+
+void glyph_set_destroy(GlyphSet *set) {
+  if (set->bitmap) {
+    gbitmap_destroy(set->bitmap);
+    set->bitmap = NULL;
+  }
+}
+
+void glyph_set_draw(GlyphSet *set, GContext *ctx, uint8_t index, int x, int y, GColor color) {
+  int width = set->cols * CELL_SIZE;
+  int height = set->rows * CELL_SIZE;
+  gbitmap_set_bounds(set->bitmap, GRect(index * width, 0, width, height));
+  glyph_mask_draw(set->bitmap, ctx, GRect(x, y, width, height), color);
+}
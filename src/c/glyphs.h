@@ -0,0 +1,28 @@
+#pragma once
+#include <pebble.h>
+#include "grid.h"
+
+// A 1-bit mask of cell shapes; set pixels take the color given when drawing.
+// Returns NULL if it does not fit in memory.
+GBitmap *glyph_mask_create(GSize size);
+// Set the pixels of one cell's stamp, with the cell's top-left at x, y
+void glyph_mask_stamp(GBitmap *mask, int x, int y, uint8_t state);
+// Draw the mask's current bounds into a layer-local rectangle
+void glyph_mask_draw(GBitmap *mask, GContext *ctx, GRect rect, GColor color);
+
+// A set of same-sized glyphs pre-rendered from their cell patterns into one
+// bitmap strip, so drawing a glyph is a single blit. Only the shapes are
+// cached: the color is applied when drawing, so color changes cost nothing.
+typedef struct {
+  GBitmap *bitmap;  // NULL if the set could not be created
+  uint8_t cols;     // Glyph size in cells
+  uint8_t rows;
+} GlyphSet;
+
+// Render count patterns of cols x rows cell states (row-major, back to back)
+bool glyph_set_create(GlyphSet *set, const uint8_t *patterns, uint8_t count,
+                      uint8_t cols, uint8_t rows);
+void glyph_set_destroy(GlyphSet *set);
+
+// Draw a glyph with its top-left cell at layer-local pixel coordinates
+void glyph_set_draw(GlyphSet *set, GContext *ctx, uint8_t index, int x, int y, GColor color);
@@ -0,0 +1,251 @@
+#include "grid.h"
+#include "profile.h"
+#include <string.h>
+
+// Pixel square drawn for each cell state, relative to the cell's top-left
+typedef struct {
+  uint8_t offset;
+  uint8_t size;
+} CellStamp;
+
+static const CellStamp s_stamps[3] = {
+  [CELL_EMPTY] = {0, 0},
+  [CELL_PARTIAL] = {PARTIAL_OFFSET, PARTIAL_SIZE},
+  [CELL_FULL] = {FULL_OFFSET, FULL_SIZE},
+};
+
+// Draw list shared by all canvases (layers draw one at a time); two buckets,
+// partial and full, per canvas color
+#define DRAW_LIST_SIZE 128
+#define DRAW_LIST_BUCKETS (GRID_CANVAS_COLORS * 2)
+static GPoint s_cell_points[DRAW_LIST_SIZE];
+static uint8_t s_cell_buckets[DRAW_LIST_SIZE];
+static uint8_t s_bucket_counts[DRAW_LIST_BUCKETS];
+static uint8_t s_cell_count;
+
+#ifdef PBL_BW
+// 1-bit rows are LSB first: one stamp row for each bit position within a byte,
+// spilling into the next byte when the stamp crosses a byte boundary
+#define STAMP_MASK(size, shift) ((uint16_t)(((1u << (size)) - 1) << (shift)))
+#define STAMP_MASKS(size) { \
+  STAMP_MASK(size, 0), STAMP_MASK(size, 1), STAMP_MASK(size, 2), STAMP_MASK(size, 3), \
+  STAMP_MASK(size, 4), STAMP_MASK(size, 5), STAMP_MASK(size, 6), STAMP_MASK(size, 7) }
+
+static const uint16_t s_stamp_masks[3][8] = {
+  [CELL_EMPTY] = {0},
+  [CELL_PARTIAL] = STAMP_MASKS(PARTIAL_SIZE),
+  [CELL_FULL] = STAMP_MASKS(FULL_SIZE),
+};
+
+#endif
+
+#ifdef PBL_ROUND
+// Round framebuffer rows have their own start and visible span; read them once
+static GBitmapDataRowInfo s_rows[PBL_DISPLAY_HEIGHT];
+static const uint8_t *s_rows_frame_data;
+
+static void prv_load_rows(GBitmap *frame_buffer, const uint8_t *data) {
+  if (s_rows_frame_data == data) return;
+  int height = gbitmap_get_bounds(frame_buffer).size.h;
+  if (height > PBL_DISPLAY_HEIGHT) height = PBL_DISPLAY_HEIGHT;
+  for (int y = 0; y < height; y++) {
+    s_rows[y] = gbitmap_get_data_row_info(frame_buffer, (uint16_t)y);
+  }
+  s_rows_frame_data = data;
+}
+#endif
+
+#ifdef PBL_ROUND
+// Doubled distance (in pixel centers) from a stamp's nearest pixel to the
+// screen center along one axis
+static int prv_stamp_distance(int cell_px, int center2) {
+  int near2 = 2 * (cell_px + FULL_OFFSET) + 1;
+  int far2 = near2 + 2 * (FULL_SIZE - 1);
+  if (center2 < near2) return near2 - center2;
+  if (center2 > far2) return center2 - far2;
+  return 0;
+}
+
+void grid_spans_build(GridSpan *spans, int grid_cols, int grid_rows,
+                      int grid_offset_x, int grid_offset_y, GSize screen) {
+  // Doubled coordinates keep the half-pixel center in integers; a pixel of
+  // slack keeps cells the display's rounded row ends still touch
+  int radius2 = screen.w + 2;
+  for (int r = 0; r < grid_rows; r++) {
+    int dy = prv_stamp_distance(grid_offset_y + r * CELL_SIZE, screen.h);
+    GridSpan span = {1, 0};
+    for (int c = 0; c < grid_cols; c++) {
+      int dx = prv_stamp_distance(grid_offset_x + c * CELL_SIZE, screen.w);
+      if (dx * dx + dy * dy > radius2 * radius2) continue;
+      if (span.first > span.last) span.first = (uint8_t)c;
+      span.last = (uint8_t)c;
+    }
+    spans[r] = span;
+  }
+}
+#endif
+
+void grid_canvas_begin(GridCanvas *canvas, GContext *ctx, Layer *layer) {
+  canvas->ctx = ctx;
+  canvas->frame = layer_get_frame(layer);
+  canvas->frame_buffer = NULL;
+  canvas->color_count = 0;
+  s_cell_count = 0;
+  memset(s_bucket_counts, 0, sizeof(s_bucket_counts));
+}
+
+// Capture the framebuffer for a flush; false if it is unavailable
+static bool prv_capture(GridCanvas *canvas) {
+  canvas->frame_buffer = graphics_capture_frame_buffer(canvas->ctx);
+  if (!canvas->frame_buffer) return false;
+  
+  canvas->data = gbitmap_get_data(canvas->frame_buffer);
+  canvas->bytes_per_row = gbitmap_get_bytes_per_row(canvas->frame_buffer);
+#ifdef PBL_ROUND
+  prv_load_rows(canvas->frame_buffer, canvas->data);
+#endif
+  
+  // Clip to the layer frame, like fill_rect does
+  GRect frame = canvas->frame;
+  GRect screen = gbitmap_get_bounds(canvas->frame_buffer);
+  int x0 = frame.origin.x > 0 ? frame.origin.x : 0;
+  int y0 = frame.origin.y > 0 ? frame.origin.y : 0;
+  int x1 = frame.origin.x + frame.size.w;
+  int y1 = frame.origin.y + frame.size.h;
+  if (x1 > screen.size.w) x1 = screen.size.w;
+  if (y1 > screen.size.h) y1 = screen.size.h;
+  canvas->clip = GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+  return true;
+}
+
+static void prv_release(GridCanvas *canvas) {
+  graphics_release_frame_buffer(canvas->ctx, canvas->frame_buffer);
+  canvas->frame_buffer = NULL;
+}
+
+// Write one bucket of same-colored, same-state cells into the framebuffer
+static void prv_stamp_bucket(GridCanvas *canvas, uint8_t bucket, uint8_t state, GColor color) {
+  const CellStamp stamp = s_stamps[state];
+  const GRect clip = canvas->clip;
+  const int clip_x1 = clip.origin.x + clip.size.w;
+  const int clip_y1 = clip.origin.y + clip.size.h;
+#ifdef PBL_BW
+  const bool white = grid_color_is_white(color);
+#else
+  if (color.a == 0) return;
+  const uint8_t argb = color.argb;
+#endif
+  
+  for (int i = 0; i < s_cell_count; i++) {
+    if (s_cell_buckets[i] != bucket) continue;
+    
+    // Stamp rectangle in screen coordinates, clipped to the layer
+    int x0 = canvas->frame.origin.x + s_cell_points[i].x + stamp.offset;
+    int y0 = canvas->frame.origin.y + s_cell_points[i].y + stamp.offset;
+    int x1 = x0 + stamp.size;
+    int y1 = y0 + stamp.size;
+    if (x0 < clip.origin.x) x0 = clip.origin.x;
+    if (y0 < clip.origin.y) y0 = clip.origin.y;
+    if (x1 > clip_x1) x1 = clip_x1;
+    if (y1 > clip_y1) y1 = clip_y1;
+    if (x0 >= x1 || y0 >= y1) continue;
+    
+#ifdef PBL_BW
+    uint16_t mask = (x1 - x0 == stamp.size) ? s_stamp_masks[state][x0 & 7]
+                                             : STAMP_MASK(x1 - x0, x0 & 7);
+    uint8_t low = (uint8_t)mask;
+    uint8_t high = (uint8_t)(mask >> 8);
+    uint8_t *row = canvas->data + y0 * canvas->bytes_per_row + (x0 >> 3);
+    for (int r = y0; r < y1; r++, row += canvas->bytes_per_row) {
+      if (white) {
+        row[0] |= low;
+        if (high) row[1] |= high;
+      } else {
+        row[0] &= (uint8_t)~low;
+        if (high) row[1] &= (uint8_t)~high;
+      }
+    }
+#else
+    for (int r = y0; r < y1; r++) {
+#ifdef PBL_ROUND
+      const GBitmapDataRowInfo *info = &s_rows[r];
+      int start = x0 > info->min_x ? x0 : info->min_x;
+      int end = x1 <= info->max_x ? x1 : info->max_x + 1;
+      if (start < end) memset(info->data + start, argb, end - start);
+#else
+      memset(canvas->data + r * canvas->bytes_per_row + x0, argb, x1 - x0);
+#endif
+    }
+#endif
+  }
+}
+
+// Fallback when the framebuffer is unavailable: fill_rect per cell
+static void prv_fill_bucket(GridCanvas *canvas, uint8_t bucket, uint8_t state) {
+  const CellStamp stamp = s_stamps[state];
+  for (int i = 0; i < s_cell_count; i++) {
+    if (s_cell_buckets[i] != bucket) continue;
+    GPoint point = s_cell_points[i];
+    PROFILE_FILL_RECT();
+    graphics_fill_rect(canvas->ctx, GRect(point.x + stamp.offset, point.y + stamp.offset,
+                                          stamp.size, stamp.size), 0, GCornerNone);
+  }
+}
+
+// Draw the queued cells, one color at a time
+static void prv_flush(GridCanvas *canvas) {
+  if (s_cell_count == 0) return;
+  bool captured = prv_capture(canvas);
+  for (int slot = 0; slot < canvas->color_count; slot++) {
+    uint8_t partial = (uint8_t)(slot * 2);
+    uint8_t full = (uint8_t)(slot * 2 + 1);
+    if (s_bucket_counts[partial] == 0 && s_bucket_counts[full] == 0) continue;
+    
+    GColor color = canvas->colors[slot];
+    if (captured) {
+      if (s_bucket_counts[partial]) prv_stamp_bucket(canvas, partial, CELL_PARTIAL, color);
+      if (s_bucket_counts[full]) prv_stamp_bucket(canvas, full, CELL_FULL, color);
+    } else {
+      graphics_context_set_fill_color(canvas->ctx, color);
+      PROFILE_COLOR_CHANGE();
+      if (s_bucket_counts[partial]) prv_fill_bucket(canvas, partial, CELL_PARTIAL);
+      if (s_bucket_counts[full]) prv_fill_bucket(canvas, full, CELL_FULL);
+    }
+  }
+  if (captured) {
+    prv_release(canvas);
+    PROFILE_CELLS(s_cell_count);
+  }
+  s_cell_count = 0;
+  memset(s_bucket_counts, 0, sizeof(s_bucket_counts));
+  canvas->color_count = 0;
+}
+
+void grid_canvas_flush(GridCanvas *canvas) {
+  prv_flush(canvas);
+}
+
+void grid_canvas_end(GridCanvas *canvas) {
+  prv_flush(canvas);
+}
+
+void grid_canvas_cell(GridCanvas *canvas, int x, int y, uint8_t state, GColor color) {
+  if (state == CELL_EMPTY) return;
+  
+  // Find or add the color's slot; a full list or palette flushes early
+  int slot = 0;
+  while (slot < canvas->color_count && !gcolor_equal(canvas->colors[slot], color)) slot++;
+  if (slot == GRID_CANVAS_COLORS || s_cell_count == DRAW_LIST_SIZE) {
+    prv_flush(canvas);
+    slot = 0;
+  }
+  if (slot == canvas->color_count) {
+    canvas->colors[canvas->color_count++] = color;
+  }
+  
+  uint8_t bucket = (uint8_t)(slot * 2 + (state == CELL_FULL));
+  s_cell_points[s_cell_count] = GPoint(x, y);
+  s_cell_buckets[s_cell_count] = bucket;
+  s_cell_count++;
+  s_bucket_counts[bucket]++;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <pebble.h>
+
+// Grid cell size (larger on Emery)
+#ifdef PBL_PLATFORM_EMERY
+  #define CELL_SIZE 6
+  #define FULL_SIZE 4
+  #define FULL_OFFSET 1
+  #define PARTIAL_SIZE 2
+  #define PARTIAL_OFFSET 2
+#elif PBL_PLATFORM_GABBRO
+  #define CELL_SIZE 7
+  #define FULL_SIZE 5
+  #define FULL_OFFSET 2
+  #define PARTIAL_SIZE 3
+  #define PARTIAL_OFFSET 3
+#else
+  #define CELL_SIZE 5
+  #define FULL_SIZE 3
+  #define FULL_OFFSET 1
+  #define PARTIAL_SIZE 1
+  #define PARTIAL_OFFSET 2
+#endif
+
+// Cell states
+#define CELL_EMPTY 0
+#define CELL_PARTIAL 1
+#define CELL_FULL 2
+
+#ifdef PBL_BW
+// 1-bit framebuffers show lighter colors as white, like fill_rect
+static inline bool grid_color_is_white(GColor color) {
+  return color.r + color.g + color.b >= 5;
+}
+#endif
+
+// Columns of one grid row that are on screen, first to last inclusive
+// (first > last when none are)
+typedef struct {
+  uint8_t first;
+  uint8_t last;
+} GridSpan;
+
+// Visible span of a row; a NULL table means every column is visible
+static inline GridSpan grid_row_span(const GridSpan *spans, int row, int grid_cols) {
+  return spans ? spans[row] : (GridSpan){0, (uint8_t)(grid_cols - 1)};
+}
+
+#ifdef PBL_ROUND
+// Fill one span per grid row with the cells whose full stamp touches the
+// round display; cells outside it would be clipped away anyway
+void grid_spans_build(GridSpan *spans, int grid_cols, int grid_rows,
+                      int grid_offset_x, int grid_offset_y, GSize screen);
+#endif
+
+// Distinct colors one canvas can queue before it has to flush early
+#define GRID_CANVAS_COLORS 4
+
+// Draws grid cells for one layer straight into the framebuffer. Cells are
+// queued in a draw list and drawn bucketed by color and state, so each color
+// is resolved (or set on the context) once per flush instead of once per cell.
+// The framebuffer is only captured while flushing, so the context stays free
+// for other drawing (e.g. glyph blits) in between.
+typedef struct {
+  GContext *ctx;
+  GRect frame;            // Layer frame on screen
+  GBitmap *frame_buffer;  // Set while flushing
+  uint8_t *data;
+  uint16_t bytes_per_row;
+  GRect clip;             // Layer frame clipped to the display
+  GColor colors[GRID_CANVAS_COLORS];
+  uint8_t color_count;
+} GridCanvas;
+
+// Start drawing cells into a layer. The layer must be a direct child of the
+// window's root layer so its frame is in screen coordinates.
+void grid_canvas_begin(GridCanvas *canvas, GContext *ctx, Layer *layer);
+
+// Draw the queued cells now; more cells can be queued afterwards
+void grid_canvas_flush(GridCanvas *canvas);
+
+// Draw the queued cells and release the framebuffer
+void grid_canvas_end(GridCanvas *canvas);
+
+// Queue a cell at layer-local pixel coordinates (top-left of the cell)
+void grid_canvas_cell(GridCanvas *canvas, int x, int y, uint8_t state, GColor color);
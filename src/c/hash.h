@@ -0,0 +1,23 @@
+#pragma once
+#include <pebble.h>
+
+// Stateless random values for grid cells: the same (seed, row, col, stream)
+// always gives the same value, so animations can look up any cell in any
+// order without a shared generator. Use a different stream for each
+// independent value of a cell (state, color, start time, ...).
+
+// 32-bit integer finalizer with good avalanche (every input bit flips about
+// half of the output bits)
+static inline uint32_t hash_mix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+  return h;
+}
+
+static inline uint32_t hash(uint32_t seed, int row, int col, uint32_t stream) {
+  uint32_t cell = ((uint32_t)(uint16_t)row << 16) | (uint16_t)col;
+  return hash_mix(hash_mix(cell ^ (stream * 0x9e3779b9u)) ^ seed);
+}
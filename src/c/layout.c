@@ -0,0 +1,85 @@
+#include "layout.h"
+
+#define TIME_HEIGHT 7
+#define STEP_BAR_HEIGHT 5
+#define DATE_HEIGHT 5
+#define SECONDS_WIDTH 7  // Two small digits and the gap between them
+#define WEATHER_HEIGHT 5  // Small digits
+
+void face_layout_build(FaceLayout *layout, int grid_cols, int grid_rows,
+                       bool show_weather, bool show_steps, bool show_battery) {
+  int spacing = (grid_cols > 24) ? 1 : 0;
+  int time_width = (spacing == 1) ? 26 : 22;
+  int date_width = (spacing == 1) ? 16 : 14;  // Increased by 1 for 2-wide separator
+  
+  // Check if weather should use step/battery position
+  bool weather_in_step_position = show_weather && !show_steps && !show_battery;
+  
+  // Only move face down if weather is enabled AND (steps OR battery are shown)
+  int vertical_offset = (show_weather && !weather_in_step_position) ? 3 : 0;
+  
+  // Center time vertically with date below (adjusted for weather)
+  int time_row = ((grid_rows - TIME_HEIGHT) / 2) + vertical_offset;
+  int step_row = time_row - STEP_BAR_HEIGHT - 2;  // 2 = gap
+  int date_row = time_row + TIME_HEIGHT + 2;      // 2 row gap after time
+  
+  // Safety check: ensure step_row is non-negative
+  if (step_row < 0) {
+    step_row = 0;
+  }
+  
+  int time_col = (grid_cols - time_width) / 2;
+  int date_col = (grid_cols - date_width) / 2 - 1;  // Moved one space left
+  
+  layout->rows = (uint8_t)grid_rows;
+  layout->digit_spacing = (uint8_t)spacing;
+  layout->weather_fits = true;
+  layout->date_fits = date_row + DATE_HEIGHT <= grid_rows;
+  layout->time = GRect(time_col, time_row, time_width, TIME_HEIGHT);
+  
+  // Two 2-glyph sides and the separator, each followed by the spacing
+  layout->date = GRect(date_col, date_row, 14 + 4 * spacing, DATE_HEIGHT);
+  
+  // Seconds centred one row below the date, if the screen has the rows
+  int seconds_row = date_row + DATE_HEIGHT + 1;
+  if (seconds_row + DATE_HEIGHT <= grid_rows) {
+    int seconds_col = date_col + (layout->date.size.w - SECONDS_WIDTH) / 2;
+    layout->seconds = GRect(seconds_col, seconds_row, SECONDS_WIDTH, DATE_HEIGHT);
+    layout->bottom = (uint8_t)(seconds_row + DATE_HEIGHT);
+  } else {
+    layout->seconds = GRectZero;
+    layout->bottom = (uint8_t)(date_row + DATE_HEIGHT);
+  }
+  
+  // Step bar (above time, aligned with left side of time)
+  layout->steps = GRect(time_col, step_row, 15, STEP_BAR_HEIGHT);
+  
+  // Battery (2x3, right edge of the time, centred in the step bar rows)
+  layout->battery = GRect(time_col + time_width - 2, step_row + 1, 2, 3);
+  
+  // Weather module
+  if (weather_in_step_position) {
+    // Weather replaces step/battery position - use step bar area
+    layout->weather = GRect(time_col, step_row, time_width, STEP_BAR_HEIGHT);
+  } else {
+    // Weather at top position, 5 grid spaces from each side
+    int weather_row = 2;
+    if (PBL_PLATFORM_TYPE_CURRENT == PlatformTypeEmery || PBL_PLATFORM_TYPE_CURRENT == PlatformTypeGabbro) {
+      weather_row = 4;  // Move further down on wider screens
+    }
+    int weather_width = grid_cols - 10;
+    int weather_height = step_row - weather_row - 2;  // 2 grid spaces padding from step tracker
+    
+    // Too short for the digits: lay out the face without the weather
+    if (show_weather && weather_height < WEATHER_HEIGHT) {
+      face_layout_build(layout, grid_cols, grid_rows, false, show_steps, show_battery);
+      layout->weather_fits = false;
+      return;
+    }
+    
+    // Safety checks: keep the box at least one cell
+    if (weather_width < 1) weather_width = 1;
+    if (weather_height < 1) weather_height = 1;
+    layout->weather = GRect(5, weather_row, weather_width, weather_height);
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <pebble.h>
+
+// Where every widget goes, in grid cells. Built when the window loads, the
+// settings change or the unobstructed screen area changes; the draw procs
+// only read it.
+typedef struct {
+  uint8_t rows;           // Grid rows the layout was built for
+  uint8_t bottom;         // Row below the lowest widget (date or seconds)
+  uint8_t digit_spacing;  // Empty column between glyphs on wide grids
+  bool weather_fits;      // False if too few rows left room for the weather
+  bool date_fits;
+  GRect time;
+  GRect date;
+  GRect steps;
+  GRect battery;
+  GRect weather;          // Box the temperature is centred in
+  GRect seconds;          // Below the date; GRectZero if there is no room
+} FaceLayout;
+
+// Build the layout for a grid of grid_cols x grid_rows cells. On short grids
+// (e.g. above Quick View) the weather and then the date are left out when
+// they no longer fit.
+void face_layout_build(FaceLayout *layout, int grid_cols, int grid_rows,
+                       bool show_weather, bool show_steps, bool show_battery);
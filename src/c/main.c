@@ -1,70 +1,158 @@
 #include <pebble.h>
 #include <string.h>
 #include "animations.h"
-
-// Grid cell size (larger on Emery)
-#ifdef PBL_PLATFORM_EMERY
-  #define CELL_SIZE 6
-  #define FULL_SIZE 4
-  #define FULL_OFFSET 1
-  #define PARTIAL_SIZE 2
-  #define PARTIAL_OFFSET 2
-#elif PBL_PLATFORM_GABBRO
-  #define CELL_SIZE 7
-  #define FULL_SIZE 5
-  #define FULL_OFFSET 2
-  #define PARTIAL_SIZE 3
-  #define PARTIAL_OFFSET 3
-#else
-  #define CELL_SIZE 5
-  #define FULL_SIZE 3
-  #define FULL_OFFSET 1
-  #define PARTIAL_SIZE 1
-  #define PARTIAL_OFFSET 2
-#endif
-
-// Cell states
-#define CELL_EMPTY 0
-#define CELL_PARTIAL 1
-#define CELL_FULL 2
+#include "grid.h"
+#include "glyphs.h"
+#include "timeline.h"
+#include "frame_clock.h"
+#include "meter.h"
+#include "settings.h"
+#include "calendar.h"
+#include "layout.h"
+#include "profile.h"
+#include "face_cache.h"
+#include "morph.h"
+#include "step_history.h"
 
 static Window *s_window;
-static Layer *s_canvas_layer;
+static Layer *s_anim_layer;
 
 // Grid dimensions (calculated based on screen size)
 static int s_grid_cols;
 static int s_grid_rows;
 static int s_grid_offset_x;
 static int s_grid_offset_y;
+#ifdef PBL_ROUND
+// Visible cells of each grid row; corner cells fall outside the circle
+static GridSpan s_grid_spans[PBL_DISPLAY_HEIGHT / CELL_SIZE];
+#endif
+#define GRID_SPANS PBL_IF_ROUND_ELSE(s_grid_spans, NULL)
 
 // Cached time values (updated once per minute)
 static uint8_t s_hour, s_minute, s_day, s_month, s_week, s_weekday, s_year;
-static int8_t s_prev_hour = -1, s_prev_minute = -1;
-
-// Animation constants
-#define ANIM_STEP 0.1f
-#define ANIM_INTERVAL_MS 100
-#define NUM_DIGITS 4
-
-// Animation state for 4 time digits (h1, h2, m1, m2)
-static int8_t s_anim_old_digits[NUM_DIGITS] = {-1, -1, -1, -1};
-static int8_t s_anim_new_digits[NUM_DIGITS] = {-1, -1, -1, -1};
-static float s_anim_progress[NUM_DIGITS] = {1.0f, 1.0f, 1.0f, 1.0f};
-static AppTimer *s_anim_timer = NULL;
 
 // Load animation
 static AnimationState s_load_anim;
 
+// Widget layers, each redrawn only when its own data changes
+static Layer *s_weather_layer;
+static Layer *s_step_layer;
+static Layer *s_battery_layer;
+static Layer *s_time_layer;
+static Layer *s_date_layer;
+static Layer *s_corners_layer;
+static Layer *s_background_layer;
+static Layer *s_seconds_layer;
+static Layer *s_face_cache_layer;
+
+// Partial frames keep the rest of the face from the previous frame (the
+// window has no background fill) and redraw just the cells of the seconds and
+// of morphing values that change
+static bool s_face_dirty = true;   // Something besides cell changes changed
+static bool s_cells_pending;       // A seconds tick or morph step asked for a frame
+static bool s_partial_frame;       // The frame being drawn is partial
+static bool s_was_animating;       // The last frame was a load animation frame
+
+// Other frames restore the cached face when nothing changed since it was
+// saved (e.g. a redraw after a notification)
+static FaceCache s_face_cache;
+static bool s_cached_frame;        // The frame being drawn restored the cache
+
+// Seconds indicator: ticks every second while shown and sleeps after
+// SECONDS_IDLE_S without a wrist tap
+#define SECONDS_IDLE_S 120
+static uint8_t s_second;
+static uint8_t s_seconds_idle;       // Seconds since the last tap
+static bool s_seconds_awake;
+static bool s_tap_subscribed;
+static TimeUnits s_tick_units;
+
+// Layout shared with the update procs (set by apply_layout)
+static FaceLayout s_layout;
+
+// Layouts for the whole grid and for the rows above the last obstruction
+// (Quick View), rebuilt when the settings or the obstruction change. Slide
+// frames only pick one of the two.
+static FaceLayout s_full_layout;
+static FaceLayout s_short_layout;
+static int s_short_rows;
+static bool s_short_applied;
+
+// Glyph bitmaps, built in prv_window_load
+static GlyphSet s_digit_glyphs;
+static GlyphSet s_small_digit_glyphs;
+static GlyphSet s_letter_glyphs;
+
 // Cached values
 static uint16_t s_steps = 0;
 static uint8_t s_battery_level = 0;
 static uint16_t s_step_goal = 8000;
 static uint8_t s_load_animation = 2;
 static int16_t s_weather_temp = 0;  // Temperature in Celsius
+static uint8_t s_weather_shape;     // Digit count and sign of the weather cells
+
+// Date line glyphs per side (letters or digits, -1 for none), cached for the day
+typedef struct {
+  bool letters;
+  int8_t glyphs[2];
+} DateSide;
+static DateSide s_date_sides[2];
+
+// Inbound messages are a packed settings blob or a weather temperature;
+// leave room for fields appended to later settings versions
+#if defined(PBL_PLATFORM_APLITE)
+#define MESSAGE_INBOX_SIZE 32
+#else
+#define MESSAGE_INBOX_SIZE 64
+#endif
+#define MESSAGE_OUTBOX_SIZE 64
+
+// Step bar and battery only redraw when their drawn level changes
+#define STEP_BAR_CELLS 75
+#define BATTERY_CELLS 6
+static Meter s_step_meter;
+static Meter s_battery_meter;
+
+// The step history view replaces the bar with today's steps per hour, read
+// ten minutes into each hour (minute data is stored with a delay). Its
+// columns reach full height at the busiest hour shown, or 1,000 steps.
+#define STEP_HISTORY_MINUTE 10
+#define STEP_HISTORY_MIN_SCALE (1000 / STEP_HISTORY_UNIT)
+static StepHistory s_step_history;
+
+// Value changes morph in ten steps, every third frame clock tick (~10 FPS)
+#define MORPH_CLOCK_DIVIDER 3
+#define MORPH_INTERVAL_MS (MORPH_CLOCK_DIVIDER * FRAME_CLOCK_MS)
+#define MORPH_DURATION_MS (10 * MORPH_INTERVAL_MS)
+#define NUM_DIGITS 4
+#define DATE_GLYPHS 4
+#define WEATHER_DIGITS 3
+#define DIGIT_CELLS 35
+#define SMALL_CELLS 15
+
+// Cell morphs of every widget value (time digits h1, h2, m1, m2, date
+// glyphs, weather digits left to right, meters, seconds), each over a
+// from/to buffer; the ones that animate share one clock
+static CellMorph s_time_morphs[NUM_DIGITS];
+static uint8_t s_time_cells[NUM_DIGITS][2 * DIGIT_CELLS];
+static CellMorph s_date_morphs[DATE_GLYPHS];
+static uint8_t s_date_cells[DATE_GLYPHS][2 * SMALL_CELLS];
+static CellMorph s_weather_morphs[WEATHER_DIGITS];
+static uint8_t s_weather_cells[WEATHER_DIGITS][2 * SMALL_CELLS];
+static CellMorph s_step_morph;
+static uint8_t s_step_cells[2 * STEP_BAR_CELLS];
+static uint8_t s_step_ranks[STEP_BAR_CELLS];
+static CellMorph s_battery_morph;
+static uint8_t s_battery_cells[2 * BATTERY_CELLS];
+static CellMorph s_seconds_morphs[2];
+static uint8_t s_seconds_cells[2][2 * SMALL_CELLS];
+static FrameClockClient s_morph_clock;
 
 // Packed boolean flags (saves memory)
 static struct {
   uint8_t health_available:1;
+  uint8_t steps_read:1;  // A step count was read since launch
+  uint8_t step_history:1;
   uint8_t show_steps:1;
   uint8_t show_battery:1;
   uint8_t show_date:1;
@@ -72,10 +160,13 @@ static struct {
   uint8_t show_weather:1;
   uint8_t weather_use_fahrenheit:1;
   uint8_t show_corners:1;
+  uint8_t show_seconds:1;
   uint8_t date_left:3;   // 0=MonthName, 1=WeekDay, 2=WeekNum, 3=Day, 4=Month, 5=Year
   uint8_t date_right:3;  // 0=MonthName, 1=WeekDay, 2=WeekNum, 3=Day, 4=Month, 5=Year
 } s_flags = {
   .health_available = 0,
+  .steps_read = 0,
+  .step_history = 0,
   .show_steps = 1,
   .show_battery = 1,
   .show_date = 1,
@@ -83,6 +174,7 @@ static struct {
   .show_weather = 0,
   .weather_use_fahrenheit = 0,
   .show_corners = 1,
+  .show_seconds = 0,
   .date_left = 3,   // Day
   .date_right = 4   // Month
 };
@@ -92,22 +184,6 @@ static GColor s_bg_color;
 static GColor s_fg_color;
 static GColor s_secondary_color;
 
-// Persist keys
-#define PERSIST_KEY_BG_COLOR 1
-#define PERSIST_KEY_FG_COLOR 2
-#define PERSIST_KEY_SECONDARY_COLOR 3
-#define PERSIST_KEY_STEP_GOAL 4
-#define PERSIST_KEY_SHOW_STEPS 5
-#define PERSIST_KEY_SHOW_BATTERY 6
-#define PERSIST_KEY_SHOW_DATE 7
-#define PERSIST_KEY_USE_24H 8
-#define PERSIST_KEY_DATE_LEFT 9
-#define PERSIST_KEY_DATE_RIGHT 10
-#define PERSIST_KEY_LOAD_ANIMATION 11
-#define PERSIST_KEY_SHOW_WEATHER 12
-#define PERSIST_KEY_WEATHER_UNIT 13
-#define PERSIST_KEY_SHOW_CORNERS 14
-
 // Small digit patterns (3x5 for each digit 0-9) - using only full cells
 static const uint8_t small_digit_patterns[10][15] = {
   {2,2,2, 2,0,2, 2,0,2, 2,0,2, 2,2,2}, // 0
@@ -146,6 +222,9 @@ static const uint8_t small_letter_patterns[19][15] = {
   {2,0,0, 2,0,0, 2,0,0, 2,0,0, 2,2,2}  // L  18
 };
 
+// Blank small glyph, for date sides without a value and unused weather digits
+static const uint8_t empty_small_pattern[15];
+
 // Weekday letter indices: [day][letter] where day: 0=Mon, 1=Tue, 2=Wed, 3=Thu, 4=Fri, 5=Sat, 6=Sun
 // Letter indices: M=0, O=1, T=2, U=3, W=4, E=5, H=6, F=7, R=8, S=9, A=10
 static const uint8_t weekday_letters[7][2] = {
@@ -189,156 +268,159 @@ static const uint8_t digit_patterns[10][35] = {
   {1,2,2,2,1, 2,0,0,0,2, 2,0,0,0,2, 1,2,2,2,2, 0,0,0,0,2, 0,0,0,0,2, 1,2,2,2,1}  // 9
 };
 
-// Draw a cell at pixel coordinates
-static inline void draw_cell_at(GContext *ctx, int x, int y, uint8_t state, bool use_secondary) {
-  if (state == CELL_EMPTY) return;
-  
-  graphics_context_set_fill_color(ctx, use_secondary ? s_secondary_color : s_fg_color);
-  
-  if (state == CELL_FULL) {
-    graphics_fill_rect(ctx, GRect(x + FULL_OFFSET, y + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
-  } else { // CELL_PARTIAL
-    graphics_fill_rect(ctx, GRect(x + PARTIAL_OFFSET, y + PARTIAL_OFFSET, PARTIAL_SIZE, PARTIAL_SIZE), 0, GCornerNone);
-  }
+// Draw a cell at layer-local pixel coordinates
+static inline void draw_cell_at(GridCanvas *canvas, int x, int y, uint8_t state, bool use_secondary) {
+  grid_canvas_cell(canvas, x, y, state, use_secondary ? s_secondary_color : s_fg_color);
+}
+
+// Blit a cached glyph at a cell position; false if the cache is unavailable
+static inline bool draw_glyph(GridCanvas *canvas, GlyphSet *set, int index, int col, int row, bool use_secondary) {
+  if (!set->bitmap) return false;
+  glyph_set_draw(set, canvas->ctx, (uint8_t)index, col * CELL_SIZE, row * CELL_SIZE,
+                 use_secondary ? s_secondary_color : s_fg_color);
+  return true;
+}
+
+// Layer frame covering a block of grid cells
+static GRect grid_rect(int col, int row, int width, int height) {
+  return GRect(s_grid_offset_x + col * CELL_SIZE, s_grid_offset_y + row * CELL_SIZE,
+               width * CELL_SIZE, height * CELL_SIZE);
 }
 
 // Helper to draw 2x2 checkerboard pattern
-static inline void draw_checkerboard_2x2(GContext *ctx, int col, int row, bool inverted, bool use_gray) {
-  int x0 = s_grid_offset_x + col * CELL_SIZE;
-  int y0 = s_grid_offset_y + row * CELL_SIZE;
-  int x1 = s_grid_offset_x + (col + 1) * CELL_SIZE;
-  int y1 = s_grid_offset_y + (row + 1) * CELL_SIZE;
+static inline void draw_checkerboard_2x2(GridCanvas *canvas, int col, int row, bool inverted, bool use_gray) {
+  int x0 = col * CELL_SIZE;
+  int y0 = row * CELL_SIZE;
+  int x1 = (col + 1) * CELL_SIZE;
+  int y1 = (row + 1) * CELL_SIZE;
   
   if (!inverted) {
-    draw_cell_at(ctx, x0, y0, CELL_FULL, use_gray);
-    draw_cell_at(ctx, x1, y0, CELL_PARTIAL, use_gray);
-    draw_cell_at(ctx, x0, y1, CELL_PARTIAL, use_gray);
-    draw_cell_at(ctx, x1, y1, CELL_FULL, use_gray);
+    draw_cell_at(canvas, x0, y0, CELL_FULL, use_gray);
+    draw_cell_at(canvas, x1, y0, CELL_PARTIAL, use_gray);
+    draw_cell_at(canvas, x0, y1, CELL_PARTIAL, use_gray);
+    draw_cell_at(canvas, x1, y1, CELL_FULL, use_gray);
   } else {
-    draw_cell_at(ctx, x0, y0, CELL_PARTIAL, use_gray);
-    draw_cell_at(ctx, x1, y0, CELL_FULL, use_gray);
-    draw_cell_at(ctx, x0, y1, CELL_FULL, use_gray);
-    draw_cell_at(ctx, x1, y1, CELL_PARTIAL, use_gray);
+    draw_cell_at(canvas, x0, y0, CELL_PARTIAL, use_gray);
+    draw_cell_at(canvas, x1, y0, CELL_FULL, use_gray);
+    draw_cell_at(canvas, x0, y1, CELL_FULL, use_gray);
+    draw_cell_at(canvas, x1, y1, CELL_PARTIAL, use_gray);
   }
 }
 
 // Draw a large digit directly
-static void draw_digit(GContext *ctx, int digit, int col, int row, bool use_gray) {
+static void draw_digit(GridCanvas *canvas, int digit, int col, int row, bool use_gray) {
   if (digit < 0 || digit > 9) return;
+  if (draw_glyph(canvas, &s_digit_glyphs, digit, col, row, use_gray)) return;
   const uint8_t *pattern = digit_patterns[digit];
   
   for (int r = 0; r < 7; r++) {
     for (int c = 0; c < 5; c++) {
       uint8_t state = pattern[r * 5 + c];
       if (state != CELL_EMPTY) {
-        int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-        int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-        draw_cell_at(ctx, x, y, state, use_gray);
+        int x = (col + c) * CELL_SIZE;
+        int y = (row + r) * CELL_SIZE;
+        draw_cell_at(canvas, x, y, state, use_gray);
       }
     }
   }
 }
 
-// Draw animated digit transition (old -> new, top to bottom)
-static void draw_digit_animated(GContext *ctx, int old_digit, int new_digit, float progress, int col, int row, bool use_gray) {
-  if (old_digit < 0 || old_digit > 9 || new_digit < 0 || new_digit > 9) return;
-  
-  const uint8_t *old_pattern = digit_patterns[old_digit];
-  const uint8_t *new_pattern = digit_patterns[new_digit];
-  
-  // Progress goes from 0.0 (show old) to 1.0 (show new)
-  // Transition line moves from row 0 to row 7
-  int transition_row = (int)(progress * 7.0f);
-  
-  for (int r = 0; r < 7; r++) {
-    for (int c = 0; c < 5; c++) {
-      uint8_t old_state = old_pattern[r * 5 + c];
-      uint8_t new_state = new_pattern[r * 5 + c];
-      uint8_t state;
-      
-      if (r < transition_row) {
-        // Above transition line: show new digit
-        state = new_state;
-      } else if (r == transition_row) {
-        // On transition line: show partial/transition state
-        if (old_state == CELL_FULL && new_state == CELL_EMPTY) {
-          state = CELL_PARTIAL;
-        } else if (old_state == CELL_EMPTY && new_state == CELL_FULL) {
-          state = CELL_PARTIAL;
-        } else if (old_state == CELL_PARTIAL && new_state == CELL_FULL) {
-          state = CELL_PARTIAL;
-        } else if (old_state == CELL_FULL && new_state == CELL_PARTIAL) {
-          state = CELL_PARTIAL;
-        } else {
-          state = new_state;
-        }
-      } else {
-        // Below transition line: show old digit
-        state = old_state;
-      }
-      
-      if (state != CELL_EMPTY) {
-        int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-        int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-        draw_cell_at(ctx, x, y, state, use_gray);
+// Draw a morph's cells with its top-left cell at a cell position. Full frames
+// draw every cell; partial frames clear the cells that changed since the last
+// frame in pass 0 and draw them again in pass 1.
+static void draw_morph(GridCanvas *canvas, CellMorph *morph, int col, int row, int pass) {
+  int count = morph_cell_count(morph);
+  int i = s_partial_frame ? morph_next_change(morph, 0) : 0;
+  while (i >= 0 && i < count) {
+    uint8_t value = morph_cell(morph, i);
+    uint8_t state = value & MORPH_STATE_MASK;
+    int x = (col + i % morph->cols) * CELL_SIZE;
+    int y = (row + i / morph->cols) * CELL_SIZE;
+    if (pass == 0) {
+      // A full stamp covers both the full and partial stamps
+      if (morph_drawn_cell(morph, i) != CELL_EMPTY && state != CELL_FULL) {
+        grid_canvas_cell(canvas, x, y, CELL_FULL, s_bg_color);
       }
+    } else if (state != CELL_EMPTY) {
+      draw_cell_at(canvas, x, y, state, (value & MORPH_SECONDARY) != 0);
     }
+    i = s_partial_frame ? morph_next_change(morph, i + 1) : i + 1;
+  }
+  if (pass == 1) morph_mark_drawn(morph);
+}
+
+typedef void (*GlyphDrawFunc)(GridCanvas *canvas, int glyph, int col, int row, bool use_gray);
+
+// Draw a glyph's morph; once settled, full frames take the glyph's own
+// (cached) drawing instead of going cell by cell
+static void draw_morph_glyph(GridCanvas *canvas, CellMorph *morph, GlyphDrawFunc draw,
+                             int glyph, int col, int row, bool use_gray, int pass) {
+  if (s_partial_frame || morph_running(morph)) {
+    draw_morph(canvas, morph, col, row, pass);
+  } else if (pass == 1) {
+    draw(canvas, glyph, col, row, use_gray);
+    morph_mark_drawn(morph);
   }
 }
 
+// Partial frames clear changed cells (pass 0) before drawing them (pass 1)
+static inline int morph_first_pass(void) {
+  return s_partial_frame ? 0 : 1;
+}
+
 // Draw a small digit directly
-static void draw_small_digit(GContext *ctx, int digit, int col, int row, bool use_gray) {
+static void draw_small_digit(GridCanvas *canvas, int digit, int col, int row, bool use_gray) {
   if (digit < 0 || digit > 9) return;
+  if (draw_glyph(canvas, &s_small_digit_glyphs, digit, col, row, use_gray)) return;
   const uint8_t *pattern = small_digit_patterns[digit];
   
   for (int r = 0; r < 5; r++) {
     for (int c = 0; c < 3; c++) {
       uint8_t state = pattern[r * 3 + c];
       if (state != CELL_EMPTY) {
-        int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-        int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-        draw_cell_at(ctx, x, y, state, use_gray);
+        int x = (col + c) * CELL_SIZE;
+        int y = (row + r) * CELL_SIZE;
+        draw_cell_at(canvas, x, y, state, use_gray);
       }
     }
   }
 }
 
 // Draw a small letter directly (for weekday and month names)
-static void draw_small_letter(GContext *ctx, int letter_index, int col, int row, bool use_gray) {
+static void draw_small_letter(GridCanvas *canvas, int letter_index, int col, int row, bool use_gray) {
   if (letter_index < 0 || letter_index > 18) return;
+  if (draw_glyph(canvas, &s_letter_glyphs, letter_index, col, row, use_gray)) return;
   const uint8_t *pattern = small_letter_patterns[letter_index];
   
   for (int r = 0; r < 5; r++) {
     for (int c = 0; c < 3; c++) {
       uint8_t state = pattern[r * 3 + c];
       if (state != CELL_EMPTY) {
-        int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-        int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-        draw_cell_at(ctx, x, y, state, use_gray);
+        int x = (col + c) * CELL_SIZE;
+        int y = (row + r) * CELL_SIZE;
+        draw_cell_at(canvas, x, y, state, use_gray);
       }
     }
   }
 }
 
 // Draw separator (vertical line for date)
-static void draw_separator(GContext *ctx, int col, int row, bool use_gray) {
+static void draw_separator(GridCanvas *canvas, int col, int row, bool use_gray) {
   // 3-row vertically centered pattern: FP, PF, FP
-  draw_checkerboard_2x2(ctx, col, row + 1, false, use_gray);
-  draw_checkerboard_2x2(ctx, col, row + 2, true, use_gray);
-  draw_cell_at(ctx, s_grid_offset_x + col * CELL_SIZE, 
-               s_grid_offset_y + (row + 3) * CELL_SIZE, CELL_FULL, use_gray);
-  draw_cell_at(ctx, s_grid_offset_x + (col + 1) * CELL_SIZE, 
-               s_grid_offset_y + (row + 3) * CELL_SIZE, CELL_PARTIAL, use_gray);
+  draw_checkerboard_2x2(canvas, col, row + 1, false, use_gray);
+  draw_checkerboard_2x2(canvas, col, row + 2, true, use_gray);
+  draw_cell_at(canvas, col * CELL_SIZE, (row + 3) * CELL_SIZE, CELL_FULL, use_gray);
+  draw_cell_at(canvas, (col + 1) * CELL_SIZE, (row + 3) * CELL_SIZE, CELL_PARTIAL, use_gray);
 }
 
 // Draw colon for time
-static void draw_colon(GContext *ctx, int col, int row) {
-  draw_checkerboard_2x2(ctx, col, row + 1, false, true);  // Top dot
-  draw_checkerboard_2x2(ctx, col, row + 4, true, true);   // Bottom dot (inverted)
+static void draw_colon(GridCanvas *canvas, int col, int row) {
+  draw_checkerboard_2x2(canvas, col, row + 1, false, true);  // Top dot
+  draw_checkerboard_2x2(canvas, col, row + 4, true, true);   // Bottom dot (inverted)
 }
 
 // Draw corner decorations
-static void draw_corners(GContext *ctx) {
+static void draw_corners(GridCanvas *canvas) {
 #ifdef PBL_ROUND
   // Round screen: 12 clock markers around the circle edge
   // sin/cos values * 1000 for angles 0,30,60,...,330 (clock positions 12,1,2,...,11)
@@ -363,10 +445,11 @@ static void draw_corners(GContext *ctx) {
     if (gc >= s_grid_cols) gc = s_grid_cols - 1;
     if (gr < 0) gr = 0;
     if (gr >= s_grid_rows) gr = s_grid_rows - 1;
+    if (gr >= s_layout.rows) continue;  // Under an obstruction
     
     // 12=full, 1=partial, 2=full, 3=partial, ...
     uint8_t state = (i % 2 == 0) ? CELL_FULL : CELL_PARTIAL;
-    draw_cell_at(ctx, s_grid_offset_x + gc * CELL_SIZE,
+    draw_cell_at(canvas, s_grid_offset_x + gc * CELL_SIZE,
                  s_grid_offset_y + gr * CELL_SIZE, state, true);
   }
 #else
@@ -374,95 +457,98 @@ static void draw_corners(GContext *ctx) {
   int x0 = s_grid_offset_x;
   int y0 = s_grid_offset_y;
   int xn = s_grid_offset_x + (s_grid_cols - 1) * CELL_SIZE;
-  int yn = s_grid_offset_y + (s_grid_rows - 1) * CELL_SIZE;
+  int yn = s_grid_offset_y + (s_layout.rows - 1) * CELL_SIZE;  // Above any obstruction
   
   // Top-left: partial at corner (fg), full adjacent (secondary)
-  graphics_context_set_fill_color(ctx, s_fg_color);
-  graphics_fill_rect(ctx, GRect(x0 + PARTIAL_OFFSET, y0 + PARTIAL_OFFSET, PARTIAL_SIZE, PARTIAL_SIZE), 0, GCornerNone);
-  graphics_context_set_fill_color(ctx, s_secondary_color);
-  graphics_fill_rect(ctx, GRect(x0 + CELL_SIZE + FULL_OFFSET, y0 + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
-  graphics_fill_rect(ctx, GRect(x0 + FULL_OFFSET, y0 + CELL_SIZE + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
+  draw_cell_at(canvas, x0, y0, CELL_PARTIAL, false);
+  draw_cell_at(canvas, x0 + CELL_SIZE, y0, CELL_FULL, true);
+  draw_cell_at(canvas, x0, y0 + CELL_SIZE, CELL_FULL, true);
   
   // Top-right
-  graphics_context_set_fill_color(ctx, s_fg_color);
-  graphics_fill_rect(ctx, GRect(xn + PARTIAL_OFFSET, y0 + PARTIAL_OFFSET, PARTIAL_SIZE, PARTIAL_SIZE), 0, GCornerNone);
-  graphics_context_set_fill_color(ctx, s_secondary_color);
-  graphics_fill_rect(ctx, GRect(xn - CELL_SIZE + FULL_OFFSET, y0 + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
-  graphics_fill_rect(ctx, GRect(xn + FULL_OFFSET, y0 + CELL_SIZE + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
+  draw_cell_at(canvas, xn, y0, CELL_PARTIAL, false);
+  draw_cell_at(canvas, xn - CELL_SIZE, y0, CELL_FULL, true);
+  draw_cell_at(canvas, xn, y0 + CELL_SIZE, CELL_FULL, true);
   
   // Bottom-left
-  graphics_context_set_fill_color(ctx, s_fg_color);
-  graphics_fill_rect(ctx, GRect(x0 + PARTIAL_OFFSET, yn + PARTIAL_OFFSET, PARTIAL_SIZE, PARTIAL_SIZE), 0, GCornerNone);
-  graphics_context_set_fill_color(ctx, s_secondary_color);
-  graphics_fill_rect(ctx, GRect(x0 + CELL_SIZE + FULL_OFFSET, yn + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
-  graphics_fill_rect(ctx, GRect(x0 + FULL_OFFSET, yn - CELL_SIZE + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
+  draw_cell_at(canvas, x0, yn, CELL_PARTIAL, false);
+  draw_cell_at(canvas, x0 + CELL_SIZE, yn, CELL_FULL, true);
+  draw_cell_at(canvas, x0, yn - CELL_SIZE, CELL_FULL, true);
   
   // Bottom-right
-  graphics_context_set_fill_color(ctx, s_fg_color);
-  graphics_fill_rect(ctx, GRect(xn + PARTIAL_OFFSET, yn + PARTIAL_OFFSET, PARTIAL_SIZE, PARTIAL_SIZE), 0, GCornerNone);
-  graphics_context_set_fill_color(ctx, s_secondary_color);
-  graphics_fill_rect(ctx, GRect(xn - CELL_SIZE + FULL_OFFSET, yn + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
-  graphics_fill_rect(ctx, GRect(xn + FULL_OFFSET, yn - CELL_SIZE + FULL_OFFSET, FULL_SIZE, FULL_SIZE), 0, GCornerNone);
+  draw_cell_at(canvas, xn, yn, CELL_PARTIAL, false);
+  draw_cell_at(canvas, xn - CELL_SIZE, yn, CELL_FULL, true);
+  draw_cell_at(canvas, xn, yn - CELL_SIZE, CELL_FULL, true);
 #endif
 }
 
-// Draw step bar (5 rows x 15 cols, fills diagonally from bottom-left)
-static void draw_step_bar(GContext *ctx, int col, int row) {
-  const int total_cells = 75;
-  int filled_cells = (s_steps * total_cells) / s_step_goal;
-  if (filled_cells > total_cells) filled_cells = total_cells;
-  
-  int remainder = (s_steps * total_cells) % s_step_goal;
-  
+static MeterLevel step_level(void) {
+  return meter_level(s_steps, s_step_goal, STEP_BAR_CELLS);
+}
+
+static MeterLevel battery_level(void) {
+  return meter_level(s_battery_level, 100, BATTERY_CELLS);
+}
+
+// Step bar cells (5 rows x 15 cols, fills diagonally from bottom-left).
+// The cells of a diagonal share a morph rank, so changes sweep along the fill.
+static void step_bar_cells(MeterLevel level, uint8_t *values, uint8_t *ranks) {
   int cell_index = 0;
-  for (int diag = 0; diag <= 18 && cell_index < total_cells; diag++) {
-    for (int c = 0; c < 15 && cell_index < total_cells; c++) {
+  for (int diag = 0; diag <= 18 && cell_index < STEP_BAR_CELLS; diag++) {
+    for (int c = 0; c < 15 && cell_index < STEP_BAR_CELLS; c++) {
       int r_from_bottom = diag - c;
       if (r_from_bottom >= 0 && r_from_bottom <= 4) {
-        int r = 4 - r_from_bottom;
-        int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-        int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-        
-        bool filled = (cell_index < filled_cells) || (cell_index == filled_cells && remainder > 0);
-        draw_cell_at(ctx, x, y, filled ? CELL_FULL : CELL_PARTIAL, !filled);
+        int cell = (4 - r_from_bottom) * 15 + c;
+        bool filled = (cell_index < level.filled) || (cell_index == level.filled && level.partial);
+        values[cell] = filled ? CELL_FULL : CELL_PARTIAL | MORPH_SECONDARY;
+        if (ranks) ranks[cell] = (uint8_t)diag;
         cell_index++;
       }
     }
   }
 }
 
-// Draw battery indicator (2 cols x 3 rows, drains top to bottom)
-static void draw_battery(GContext *ctx, int col, int row) {
-  const int total_cells = 6;
-  int filled_cells = (s_battery_level * total_cells) / 100;
-  int remainder = (s_battery_level * total_cells) % 100;
+// Step history sparkline in the step bar's cells: the last 15 hours read,
+// newest on the right, as columns scaled to the busiest of them
+static void step_history_cells(uint8_t *values) {
+  int first = s_step_history.read_hours - 15;
+  int scale = STEP_HISTORY_MIN_SCALE;
+  for (int hour = first < 0 ? 0 : first; hour < s_step_history.read_hours; hour++) {
+    if (s_step_history.hours[hour] > scale) scale = s_step_history.hours[hour];
+  }
   
-  int cell_index = 0;
-  for (int r = 0; r < 3; r++) {
-    for (int c = 0; c < 2; c++) {
-      int x = s_grid_offset_x + (col + c) * CELL_SIZE;
-      int y = s_grid_offset_y + (row + r) * CELL_SIZE;
-      
-      // Calculate which cell from bottom (0 = bottom, 5 = top)
-      int cell_from_bottom = total_cells - 1 - cell_index;
-      
-      if (cell_from_bottom < filled_cells) {
-        // Fully filled cell - use primary color
-        draw_cell_at(ctx, x, y, CELL_FULL, false);
-      } else if (cell_from_bottom == filled_cells && remainder > 0) {
-        // Partially filled cell (transition) - use secondary color
-        draw_cell_at(ctx, x, y, CELL_PARTIAL, false);
-      } else {
-        // Empty (drained) cell - use secondary color
-        draw_cell_at(ctx, x, y, CELL_PARTIAL, true);
-      }
-      cell_index++;
+  for (int c = 0; c < 15; c++) {
+    int hour = first + c;
+    int units = hour >= 0 ? s_step_history.hours[hour] : 0;
+    // Any steps show at least one cell
+    int height = (units * 5 + scale - 1) / scale;
+    for (int r = 0; r < 5; r++) {
+      values[r * 15 + c] = (4 - r) < height ? CELL_FULL : CELL_PARTIAL | MORPH_SECONDARY;
     }
   }
 }
 
-// Draw weather module with temperature
-static void draw_weather(GContext *ctx, int col, int row, int width, int height, int temperature) {
+// Battery indicator cells (2 cols x 3 rows, drains top to bottom)
+static void battery_cells(MeterLevel level, uint8_t *values) {
+  for (int cell_index = 0; cell_index < BATTERY_CELLS; cell_index++) {
+    // Calculate which cell from bottom (0 = bottom, 5 = top)
+    int cell_from_bottom = BATTERY_CELLS - 1 - cell_index;
+    
+    if (cell_from_bottom < level.filled) {
+      // Fully filled cell - use primary color
+      values[cell_index] = CELL_FULL;
+    } else if (cell_from_bottom == level.filled && level.partial) {
+      // Partially filled cell (transition) - use primary color
+      values[cell_index] = CELL_PARTIAL;
+    } else {
+      // Empty (drained) cell - use secondary color
+      values[cell_index] = CELL_PARTIAL | MORPH_SECONDARY;
+    }
+  }
+}
+
+// Draw weather module with temperature; the digits are morphs, the minus sign
+// and degree symbol only change in full frames
+static void draw_weather(GridCanvas *canvas, int col, int row, int width, int height, int temperature, int pass) {
   // Safety checks
   if (width < 1 || height < 1) return;
   if (col < 0 || row < 0) return;
@@ -484,519 +570,802 @@ static void draw_weather(GContext *ctx, int col, int row, int width, int height,
   int c = start_col;
 
   // Draw minus sign to the left of the digits (3 wide + 1 spacing)
-  if (is_negative && start_col - 4 >= col) {
+  if (!s_partial_frame && is_negative && start_col - 4 >= col) {
     // Draw horizontal line in middle row (row 2 out of 0-4)
     for (int i = 0; i < 3; i++) {
-      int x = s_grid_offset_x + (start_col - 4 + i) * CELL_SIZE;
-      int y = s_grid_offset_y + (row + 2) * CELL_SIZE;
-      draw_cell_at(ctx, x, y, CELL_FULL, false);
+      int x = (start_col - 4 + i) * CELL_SIZE;
+      int y = (row + 2) * CELL_SIZE;
+      draw_cell_at(canvas, x, y, CELL_FULL, false);
     }
   }
 
   // Extract digits
-  int d1 = temp / 100;
-  int d2 = (temp / 10) % 10;
-  int d3 = temp % 10;
+  int digits[WEATHER_DIGITS] = {temp / 100, (temp / 10) % 10, temp % 10};
   
   // Draw digits based on number of digits
-  if (num_digits == 3) {
-    draw_small_digit(ctx, d1, c, row, false);
-    c += 3 + 1;
-  }
-  if (num_digits >= 2) {
-    draw_small_digit(ctx, d2, c, row, false);
+  for (int i = 0; i < num_digits; i++) {
+    draw_morph_glyph(canvas, &s_weather_morphs[i], draw_small_digit,
+                     digits[WEATHER_DIGITS - num_digits + i], c, row, false, pass);
     c += 3 + 1;
   }
-  draw_small_digit(ctx, d3, c, row, false);
-  c += 3 + 1;
   
   // Draw degree symbol (small circle - 2x2) to the right of the digits
-  if (c + 1 >= s_grid_cols) return;
-  int x = s_grid_offset_x + c * CELL_SIZE;
-  int y = s_grid_offset_y + row * CELL_SIZE;
-  draw_cell_at(ctx, x, y, CELL_PARTIAL, true);
-  draw_cell_at(ctx, x + CELL_SIZE, y, CELL_PARTIAL, true);
-  draw_cell_at(ctx, x, y + CELL_SIZE, CELL_PARTIAL, true);
-  draw_cell_at(ctx, x + CELL_SIZE, y + CELL_SIZE, CELL_PARTIAL, true);
-}
-
-// Canvas update procedure - draws everything directly, no buffer
-static void canvas_update_proc(Layer *layer, GContext *ctx) {
-  // Draw load animation on top if active - skip normal content
-  if (animations_is_active(&s_load_anim)) {
-    animations_draw(ctx, &s_load_anim,
-                   s_grid_cols, s_grid_rows,
-                   s_grid_offset_x, s_grid_offset_y,
-                   CELL_SIZE, FULL_SIZE, FULL_OFFSET,
-                   PARTIAL_SIZE, PARTIAL_OFFSET,
-                   s_fg_color, s_secondary_color);
-    return;  // Don't draw normal content during animation
+  if (s_partial_frame || c + 1 >= s_grid_cols) return;
+  int x = c * CELL_SIZE;
+  int y = row * CELL_SIZE;
+  draw_cell_at(canvas, x, y, CELL_PARTIAL, true);
+  draw_cell_at(canvas, x + CELL_SIZE, y, CELL_PARTIAL, true);
+  draw_cell_at(canvas, x, y + CELL_SIZE, CELL_PARTIAL, true);
+  draw_cell_at(canvas, x + CELL_SIZE, y + CELL_SIZE, CELL_PARTIAL, true);
+}
+
+// Widgets draw nothing while the load animation covers the face
+static inline bool face_hidden(void) {
+  return animations_is_active(&s_load_anim);
+}
+
+// ...nor in frames that restored the cached face
+static inline bool morph_skipped(void) {
+  return face_hidden() || s_cached_frame;
+}
+
+// ...and static widgets skip partial frames, which keep what they drew last time
+static inline bool face_skipped(void) {
+  return morph_skipped() || s_partial_frame;
+}
+
+// Redraw a widget, which also means redrawing the whole face
+static void face_mark_dirty(Layer *layer) {
+  s_face_dirty = true;
+  face_cache_invalidate(&s_face_cache);
+  layer_mark_dirty(layer);
+}
+
+// Background layer is drawn first, so it decides what kind of frame this is
+static void background_update_proc(Layer *layer, GContext *ctx) {
+  bool animating = animations_is_active(&s_load_anim);
+  s_partial_frame = s_cells_pending && !s_face_dirty && !animating && !s_was_animating;
+  s_was_animating = animating;
+  s_face_dirty = false;
+  s_cells_pending = false;
+  s_cached_frame = false;
+  if (s_partial_frame) return;
+  
+  if (!face_hidden() && face_cache_restore(&s_face_cache, ctx)) {
+    s_cached_frame = true;
+    return;
+  }
+  graphics_context_set_fill_color(ctx, s_bg_color);
+  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+}
+
+// Weather layer: full grid width, weather box columns inside it
+static void weather_update_proc(Layer *layer, GContext *ctx) {
+  if (morph_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_WEATHER);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  
+  // Convert temperature if needed (data is always in Celsius)
+  int display_temp = s_weather_temp;
+  if (s_flags.weather_use_fahrenheit) {
+    // Convert C to F: (C * 9/5) + 32
+    display_temp = (s_weather_temp * 9 / 5) + 32;
   }
   
-  // Calculate layout
-  int digit_spacing = (s_grid_cols > 24) ? 1 : 0;
-  int time_width = (digit_spacing == 1) ? 26 : 22;
-  int small_spacing = digit_spacing;
-  int date_width = (small_spacing == 1) ? 16 : 14;  // Increased by 1 for 2-wide separator
-  
-  // Check if weather should use step/battery position
-  bool weather_in_step_position = s_flags.show_weather && !s_flags.show_steps && !s_flags.show_battery;
-  
-  // Calculate vertical offset for weather module
-  // Only move face down if weather is enabled AND (steps OR battery are shown)
-  int vertical_offset = (s_flags.show_weather && !weather_in_step_position) ? 3 : 0;
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    draw_weather(&canvas, s_layout.weather.origin.x, 0, s_layout.weather.size.w, s_layout.weather.size.h,
+                 display_temp, pass);
+    grid_canvas_flush(&canvas);
+  }
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_WEATHER);
+}
+
+static void step_update_proc(Layer *layer, GContext *ctx) {
+  if (morph_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_STEPS);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    draw_morph(&canvas, &s_step_morph, 0, 0, pass);
+    grid_canvas_flush(&canvas);
+  }
+  if (!s_flags.step_history) meter_drawn(&s_step_meter, step_level());
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_STEPS);
+}
+
+static void battery_update_proc(Layer *layer, GContext *ctx) {
+  if (morph_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_BATTERY);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    draw_morph(&canvas, &s_battery_morph, 0, 0, pass);
+    grid_canvas_flush(&canvas);
+  }
+  meter_drawn(&s_battery_meter, battery_level());
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_BATTERY);
+}
+
+static void time_update_proc(Layer *layer, GContext *ctx) {
+  if (morph_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_TIME);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
   
-  // Center time vertically with date below (adjusted for weather)
-  int time_row = ((s_grid_rows - 7) / 2) + vertical_offset;  // 7 = time height
-  int step_row = time_row - 5 - 2;        // 5 = step bar height, 2 = gap
-  int date_row = time_row + 7 + 2;        // 2 row gap after time
+  // Time digits (h1, h2, m1, m2)
+  int digits[NUM_DIGITS] = {s_hour / 10, s_hour % 10, s_minute / 10, s_minute % 10};
   
-  // Safety check: ensure step_row is non-negative
-  if (step_row < 0) {
-    step_row = 0;
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    int col = 0;
+    for (int i = 0; i < NUM_DIGITS; i++) {
+      // Hour tens use the secondary color if zero
+      draw_morph_glyph(&canvas, &s_time_morphs[i], draw_digit, digits[i], col, 0,
+                       i == 0 && digits[0] == 0, pass);
+      col += 5 + s_layout.digit_spacing;
+      
+      // Colon between hours and minutes
+      if (i == 1) {
+        if (!s_partial_frame) draw_colon(&canvas, col, 0);
+        col += 2 + s_layout.digit_spacing;
+      }
+    }
+    grid_canvas_flush(&canvas);
   }
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_TIME);
+}
+
+static void date_update_proc(Layer *layer, GContext *ctx) {
+  if (morph_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_DATE);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
   
-  int time_col = (s_grid_cols - time_width) / 2;
-  int date_col = (s_grid_cols - date_width) / 2 - 1;  // Moved one space left
+  int small_spacing = s_layout.digit_spacing;
   
-  // Weather module (if enabled)
-  if (s_flags.show_weather) {
-    int weather_row, weather_col, weather_width, weather_height;
-    
-    if (weather_in_step_position) {
-      // Weather replaces step/battery position - use step bar area
-      weather_row = step_row;
-      weather_col = time_col;
-      weather_width = time_width;
-      weather_height = 5;  // Same height as step bar
-    } else {
-      // Weather at top position
-      weather_row = 2;  // 2 grid spaces from top
-      weather_col = 5;  // 5 grid spaces from left
-      if (PBL_PLATFORM_TYPE_CURRENT == PlatformTypeEmery || PBL_PLATFORM_TYPE_CURRENT == PlatformTypeGabbro) {
-        weather_row = 4;  // Move further down on wider screens
-      }
-      weather_width = s_grid_cols - 10;  // 5 from each side
-      weather_height = step_row - weather_row - 2;  // 2 grid spaces padding from step tracker
-      
-      // Safety check: ensure weather_width is positive
-      if (weather_width < 1) {
-        weather_width = 1;
+  // Glyphs are cached by update_date_glyphs
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    int col = 0;
+    for (int side = 0; side < 2; side++) {
+      const DateSide *date_side = &s_date_sides[side];
+      GlyphDrawFunc draw = date_side->letters ? draw_small_letter : draw_small_digit;
+      for (int i = 0; i < 2; i++) {
+        draw_morph_glyph(&canvas, &s_date_morphs[side * 2 + i], draw, date_side->glyphs[i],
+                         col, 0, true, pass);
+        col += 3 + small_spacing;
       }
       
-      // Safety check: ensure weather_height is positive
-      if (weather_height < 1) {
-        weather_height = 1;
+      // Draw separator after left side
+      if (side == 0) {
+        if (!s_partial_frame) draw_separator(&canvas, col, 0, true);
+        col += 2 + small_spacing;
       }
     }
-    
-    // Convert temperature if needed (data is always in Celsius)
-    int display_temp = s_weather_temp;
-    if (s_flags.weather_use_fahrenheit) {
-      // Convert C to F: (C * 9/5) + 32
-      display_temp = (s_weather_temp * 9 / 5) + 32;
-    }
-    
-    draw_weather(ctx, weather_col, weather_row, weather_width, weather_height, display_temp);
+    grid_canvas_flush(&canvas);
   }
-  
-  // Step bar (above time, aligned with left side of time)
-  if (s_flags.show_steps && s_flags.health_available) {
-    draw_step_bar(ctx, time_col, step_row);
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_DATE);
+}
+
+// Sits above the static widgets and below the seconds: saves the finished
+// face once nothing on it is morphing, which may be in a partial frame (the
+// seconds in there are cleared when it is restored)
+static void face_cache_update_proc(Layer *layer, GContext *ctx) {
+  if (face_hidden() || s_face_cache.valid || frame_clock_is_active(&s_morph_clock)) return;
+  face_cache_save(&s_face_cache, ctx);
+}
+
+// Seconds as two small digits, morphing without animation: partial
+// frames clear and draw just the cells that differ from the digits on screen
+static void seconds_update_proc(Layer *layer, GContext *ctx) {
+  if (face_hidden()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_SECONDS);
+  
+  // The cached face may hold older seconds
+  if (s_cached_frame) {
+    graphics_context_set_fill_color(ctx, s_bg_color);
+    graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
   }
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
   
-  // Battery indicator (right side, aligned with right edge of time, vertically centered with step bar)
-  if (s_flags.show_battery) {
-    int battery_col = time_col + time_width - 2;  // 2 cols wide, align right edge
-    int battery_row = step_row + 1;  // Center in 5-row step area (5-3)/2 = 1
-    draw_battery(ctx, battery_col, battery_row);
+  int digits[2] = {s_second / 10, s_second % 10};
+  for (int pass = morph_first_pass(); pass < 2; pass++) {
+    for (int i = 0; i < 2; i++) {
+      draw_morph_glyph(&canvas, &s_seconds_morphs[i], draw_small_digit, digits[i], i * 4, 0, true, pass);
+    }
+    grid_canvas_flush(&canvas);
   }
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_SECONDS);
+}
+
+// Corners layer covers the whole window
+static void corners_update_proc(Layer *layer, GContext *ctx) {
+  if (face_skipped()) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_CORNERS);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  draw_corners(&canvas);
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_CORNERS);
+}
+
+// Load animation layer sits on top of the widgets
+static void anim_update_proc(Layer *layer, GContext *ctx) {
+  if (!animations_is_active(&s_load_anim)) return;
+  PROFILE_WIDGET_BEGIN(PROFILE_ANIMATION);
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  animations_draw(&canvas, &s_load_anim,
+                 s_grid_cols, s_grid_rows, GRID_SPANS,
+                 s_grid_offset_x, s_grid_offset_y,
+                 s_fg_color, s_secondary_color);
+  grid_canvas_end(&canvas);
+  PROFILE_WIDGET_END(PROFILE_ANIMATION);
+}
+
+#ifdef GRIDSPACE_PROFILE
+// Profiling layer sits above everything, so its draw closes the frame
+static Layer *s_profile_layer;
+
+#ifdef GRIDSPACE_PROFILE_OVERLAY
+// Width in cells of a number drawn in small digits
+static int profile_number_width(uint32_t value) {
+  int digits = 1;
+  for (value /= 10; value > 0; value /= 10) digits++;
+  return digits * 4 - 1;
+}
+
+// Draw a number in small digits starting at the given cell
+static void draw_profile_number(GridCanvas *canvas, uint32_t value, int col, int row) {
+  int c = col + profile_number_width(value) - 3;
+  do {
+    draw_small_digit(canvas, (int)(value % 10), c, row, true);
+    value /= 10;
+    c -= 4;
+  } while (value > 0);
+}
+#endif
+
+static void profile_update_proc(Layer *layer, GContext *ctx) {
+  profile_frame_end();
+#ifdef GRIDSPACE_PROFILE_OVERLAY
+  if (s_partial_frame) return;
+  
+  // Last frame's draw time left of centre, timer wakeups so far right of it
+  const ProfileStats *stats = profile_stats();
+  int row = s_layout.rows - 6;
+  int center = s_grid_cols / 2;
+  GridCanvas canvas;
+  grid_canvas_begin(&canvas, ctx, layer);
+  draw_profile_number(&canvas, stats->last_frame_ms,
+                      center - 1 - profile_number_width(stats->last_frame_ms), row);
+  draw_profile_number(&canvas, stats->wakeups, center + 1, row);
+  grid_canvas_end(&canvas);
+#endif
+}
+#endif
+
+static GRect grid_rect_of(GRect cells) {
+  return grid_rect(cells.origin.x, cells.origin.y, cells.size.w, cells.size.h);
+}
+
+// Seconds are shown when enabled, awake and the layout has room for them
+static bool seconds_shown(void) {
+  return s_flags.show_seconds && s_seconds_awake && s_layout.seconds.size.w > 0;
+}
+
+static void update_tick_units(void);
+
+// Position the widget layers for a layout and redraw the face
+static void apply_layout(const FaceLayout *layout) {
+  s_layout = *layout;
   
-  // Time digits
-  int h1 = s_hour / 10;
-  int h2 = s_hour % 10;
-  int m1 = s_minute / 10;
-  int m2 = s_minute % 10;
+  // Weather digits are 5 rows tall whatever the box height
+  layer_set_frame(s_weather_layer, grid_rect(0, s_layout.weather.origin.y, s_grid_cols, 5));
+  layer_set_hidden(s_weather_layer, !(s_flags.show_weather && s_layout.weather_fits));
   
-  int col = time_col;
+  layer_set_frame(s_step_layer, grid_rect_of(s_layout.steps));
+  layer_set_hidden(s_step_layer, !(s_flags.show_steps && s_flags.health_available));
   
-  // Hour tens (use secondary color if zero)
-  bool h1_use_gray = (h1 == 0);
-  if (s_anim_progress[0] < 1.0f) {
-    draw_digit_animated(ctx, s_anim_old_digits[0], s_anim_new_digits[0], s_anim_progress[0], col, time_row, h1_use_gray);
-  } else {
-    draw_digit(ctx, h1, col, time_row, h1_use_gray);
-  }
-  col += 5 + digit_spacing;
+  layer_set_frame(s_battery_layer, grid_rect_of(s_layout.battery));
+  layer_set_hidden(s_battery_layer, !s_flags.show_battery);
   
-  // Hour ones
-  if (s_anim_progress[1] < 1.0f) {
-    draw_digit_animated(ctx, s_anim_old_digits[1], s_anim_new_digits[1], s_anim_progress[1], col, time_row, false);
-  } else {
-    draw_digit(ctx, h2, col, time_row, false);
-  }
-  col += 5 + digit_spacing;
+  layer_set_frame(s_time_layer, grid_rect_of(s_layout.time));
   
-  // Colon (shift right by 1 on larger screens)
-  int colon_offset = 0;
-  draw_colon(ctx, col + colon_offset, time_row);
-  col += 2 + digit_spacing;
+  layer_set_frame(s_date_layer, grid_rect_of(s_layout.date));
+  layer_set_hidden(s_date_layer, !(s_flags.show_date && s_layout.date_fits));
   
-  // Minutes
-  if (s_anim_progress[2] < 1.0f) {
-    draw_digit_animated(ctx, s_anim_old_digits[2], s_anim_new_digits[2], s_anim_progress[2], col, time_row, false);
-  } else {
-    draw_digit(ctx, m1, col, time_row, false);
+  // The seconds may have lost or regained their room
+  layer_set_frame(s_seconds_layer, grid_rect_of(s_layout.seconds));
+  layer_set_hidden(s_seconds_layer, !seconds_shown());
+  update_tick_units();
+  
+  layer_set_hidden(s_corners_layer, !s_flags.show_corners);
+  face_cache_retry(&s_face_cache);
+  face_mark_dirty(window_get_root_layer(s_window));
+}
+
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+// Whole grid rows inside an unobstructed screen area
+static int unobstructed_rows(GRect area) {
+  int rows = (area.origin.y + area.size.h - s_grid_offset_y) / CELL_SIZE;
+  return rows < s_grid_rows ? rows : s_grid_rows;
+}
+
+static int visible_rows(void) {
+  return unobstructed_rows(layer_get_unobstructed_bounds(window_get_root_layer(s_window)));
+}
+#else
+static int visible_rows(void) {
+  return s_grid_rows;
+}
+#endif
+
+// Row below the lowest widget the full layout shows: its bottom counts the
+// seconds slot even with the seconds off, and the date even when hidden
+static int full_layout_bottom(void) {
+  const FaceLayout *layout = &s_full_layout;
+  if (s_flags.show_seconds && layout->seconds.size.w > 0) return layout->bottom;
+  if (s_flags.show_date && layout->date_fits) return layout->date.origin.y + layout->date.size.h;
+  return layout->time.origin.y + layout->time.size.h;
+}
+
+// Apply the full layout while its widgets are all visible, else the short one
+static void apply_layout_for_rows(int rows, bool force) {
+  bool use_short = full_layout_bottom() > rows;
+  if (use_short == s_short_applied && !force) return;
+  s_short_applied = use_short;
+  apply_layout(use_short ? &s_short_layout : &s_full_layout);
+}
+
+static void build_short_layout(void) {
+  face_layout_build(&s_short_layout, s_grid_cols, s_short_rows,
+                    s_flags.show_weather, s_flags.show_steps, s_flags.show_battery);
+}
+
+// Rebuild the layouts for the current settings and apply the one that fits
+static void update_layout(void) {
+  face_layout_build(&s_full_layout, s_grid_cols, s_grid_rows,
+                    s_flags.show_weather, s_flags.show_steps, s_flags.show_battery);
+  build_short_layout();
+  apply_layout_for_rows(visible_rows(), true);
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+// Quick View is about to slide in or out: build the layout for the rows it
+// leaves uncovered once, before the slide
+static void unobstructed_will_change(GRect final_unobstructed_screen_area, void *context) {
+  int rows = unobstructed_rows(final_unobstructed_screen_area);
+  if (rows >= s_grid_rows || rows == s_short_rows) return;
+  s_short_rows = rows;
+  build_short_layout();
+  if (s_short_applied) apply_layout_for_rows(visible_rows(), true);
+}
+
+// Slide frames switch layouts at most once, when the edge passes the date
+static void unobstructed_change(AnimationProgress progress, void *context) {
+  apply_layout_for_rows(visible_rows(), false);
+}
+
+static void unobstructed_did_change(void *context) {
+  apply_layout_for_rows(visible_rows(), false);
+}
+#endif
+
+// Step a widget's running morphs and mark its layer dirty if any moved
+static bool step_morphs(CellMorph *morphs, int count, Layer *layer) {
+  bool running = false;
+  for (int i = 0; i < count; i++) {
+    if (!morph_running(&morphs[i])) continue;
+    morph_step(&morphs[i], MORPH_INTERVAL_MS);
+    running |= morph_running(&morphs[i]);
+    layer_mark_dirty(layer);
   }
-  col += 5 + digit_spacing;
-  if (s_anim_progress[3] < 1.0f) {
-    draw_digit_animated(ctx, s_anim_old_digits[3], s_anim_new_digits[3], s_anim_progress[3], col, time_row, false);
-  } else {
-    draw_digit(ctx, m2, col, time_row, false);
+  return running;
+}
+
+// Morph step for every widget; the frames only redraw the cells that change
+static bool morph_clock_step(void *data) {
+  bool running = step_morphs(s_time_morphs, NUM_DIGITS, s_time_layer);
+  running |= step_morphs(s_date_morphs, DATE_GLYPHS, s_date_layer);
+  running |= step_morphs(s_weather_morphs, WEATHER_DIGITS, s_weather_layer);
+  running |= step_morphs(&s_step_morph, 1, s_step_layer);
+  running |= step_morphs(&s_battery_morph, 1, s_battery_layer);
+  s_cells_pending = true;
+  return running;
+}
+
+// Move a widget's morph to new cell values: animated on the morph clock, or
+// as a jump that redraws the whole face. Hidden widgets just jump; they are
+// drawn in full when they show again.
+static void widget_morph(CellMorph *morph, const uint8_t *values, uint8_t flags, Layer *layer, bool animate) {
+  if (layer_get_hidden(layer)) {
+    morph_set(morph, values, flags);
+  } else if (!animate) {
+    morph_set(morph, values, flags);
+    face_mark_dirty(layer);
+  } else if (morph_start(morph, values, flags, MORPH_DURATION_MS)) {
+    face_cache_invalidate(&s_face_cache);
+    s_cells_pending = true;
+    layer_mark_dirty(layer);
+    if (!frame_clock_is_active(&s_morph_clock)) frame_clock_start(&s_morph_clock);
   }
-  
-  // Date digits (if enabled)
-  if (s_flags.show_date) {
-    col = date_col;
-    
-    // Helper to draw a date component based on type
-    // 0=MonthName, 1=WeekDay, 2=WeekNum, 3=Day, 4=Month, 5=Year
-    for (int side = 0; side < 2; side++) {
-      uint8_t date_type = (side == 0) ? s_flags.date_left : s_flags.date_right;
-      
-      switch (date_type) {
-        case 0: // Month Name (2 letters)
-          if (s_month >= 1 && s_month <= 12) {
-            draw_small_letter(ctx, month_letters[s_month - 1][0], col, date_row, true);
-            col += 3 + small_spacing;
-            draw_small_letter(ctx, month_letters[s_month - 1][1], col, date_row, true);
-          }
-          break;
-        case 1: // Week Day (2 letters)
-          if (s_weekday <= 6) {
-            draw_small_letter(ctx, weekday_letters[s_weekday][0], col, date_row, true);
-            col += 3 + small_spacing;
-            draw_small_letter(ctx, weekday_letters[s_weekday][1], col, date_row, true);
-          }
-          break;
-        case 2: // Week of the Year
-          draw_small_digit(ctx, s_week / 10, col, date_row, true);
-          col += 3 + small_spacing;
-          draw_small_digit(ctx, s_week % 10, col, date_row, true);
-          break;
-        case 3: // Day
-          draw_small_digit(ctx, s_day / 10, col, date_row, true);
-          col += 3 + small_spacing;
-          draw_small_digit(ctx, s_day % 10, col, date_row, true);
-          break;
-        case 4: // Month (number)
-          draw_small_digit(ctx, s_month / 10, col, date_row, true);
-          col += 3 + small_spacing;
-          draw_small_digit(ctx, s_month % 10, col, date_row, true);
-          break;
-        case 5: // Year (last 2 digits)
-          draw_small_digit(ctx, s_year / 10, col, date_row, true);
-          col += 3 + small_spacing;
-          draw_small_digit(ctx, s_year % 10, col, date_row, true);
-          break;
-      }
-      col += 3 + small_spacing;
-      
-      // Draw separator after left side
-      if (side == 0) {
-        draw_separator(ctx, col, date_row, true);
-        col += 2 + small_spacing;
-      }
-    }
+}
+
+static void update_step_cells(bool animate) {
+  uint8_t values[STEP_BAR_CELLS];
+  if (s_flags.step_history) {
+    step_history_cells(values);
+  } else {
+    step_bar_cells(step_level(), values, NULL);
   }
-  
-  // Corners
-  if (s_flags.show_corners) {
-    draw_corners(ctx);
+  widget_morph(&s_step_morph, values, 0, s_step_layer, animate);
+}
+
+static void update_battery_cells(bool animate) {
+  uint8_t values[BATTERY_CELLS];
+  battery_cells(battery_level(), values);
+  widget_morph(&s_battery_morph, values, 0, s_battery_layer, animate);
+}
+
+// Refresh the step count; the bar morphs only if its level changes, and
+// jumps to the first count after launch. The history view does not use it.
+static void update_steps(void) {
+  if (s_flags.step_history) return;
+  s_steps = (uint16_t)health_service_sum_today(HealthMetricStepCount);
+  if (meter_update(&s_step_meter, step_level())) {
+    update_step_cells(s_step_meter.valid && s_flags.steps_read);
   }
+  s_flags.steps_read = 1;
 }
 
-// Animation timer callback
-static void animation_timer_callback(void *data) {
-  bool still_animating = false;
-  
-  for (int i = 0; i < NUM_DIGITS; i++) {
-    if (s_anim_progress[i] < 1.0f) {
-      s_anim_progress[i] += ANIM_STEP;
-      s_anim_progress[i] = (s_anim_progress[i] >= 1.0f) ? 1.0f : s_anim_progress[i];
-      still_animating |= (s_anim_progress[i] < 1.0f);
-    }
+// Read the hours the step history is missing; false if it is not shown
+static bool update_step_history(void) {
+  if (!s_flags.health_available || !s_flags.step_history) return false;
+  step_history_update(&s_step_history, time(NULL));
+  return true;
+}
+
+// Weather digits morph while the temperature keeps its sign and digit count;
+// otherwise the minus sign and degree symbol move, so the widget jumps
+static void update_weather(bool animate) {
+  // Convert temperature if needed (data is always in Celsius)
+  int temp = s_weather_temp;
+  if (s_flags.weather_use_fahrenheit) {
+    temp = (s_weather_temp * 9 / 5) + 32;
   }
+  bool is_negative = temp < 0;
+  if (is_negative) temp = -temp;
+  int num_digits = (temp >= 100) ? 3 : (temp >= 10) ? 2 : 1;
   
-  layer_mark_dirty(s_canvas_layer);
+  uint8_t shape = (uint8_t)(num_digits | (is_negative ? 0x80 : 0));
+  animate = animate && shape == s_weather_shape;
+  s_weather_shape = shape;
   
-  if (still_animating) {
-    s_anim_timer = app_timer_register(ANIM_INTERVAL_MS, animation_timer_callback, NULL);
-  } else {
-    s_anim_timer = NULL;
+  int digits[WEATHER_DIGITS] = {temp / 100, (temp / 10) % 10, temp % 10};
+  for (int i = 0; i < WEATHER_DIGITS; i++) {
+    const uint8_t *pattern = i < num_digits ?
+        small_digit_patterns[digits[WEATHER_DIGITS - num_digits + i]] : empty_small_pattern;
+    widget_morph(&s_weather_morphs[i], pattern, 0, s_weather_layer, animate);
   }
 }
 
-// Update cached time
-static void update_time(void) {
-  time_t temp = time(NULL);
-  struct tm *t = localtime(&temp);
-  
-  uint8_t new_hour = (uint8_t)t->tm_hour;
-  uint8_t new_minute = (uint8_t)t->tm_min;
+// Cache the date line's glyphs for the current day and date settings, and
+// morph to them (a new day) or jump (new settings)
+static void update_date_glyphs(bool animate) {
+  for (int side = 0; side < 2; side++) {
+    DateSide *date_side = &s_date_sides[side];
+    uint8_t date_type = (side == 0) ? s_flags.date_left : s_flags.date_right;
+    int value = -1;
+    date_side->letters = false;
+    date_side->glyphs[0] = date_side->glyphs[1] = -1;
+    
+    // 0=MonthName, 1=WeekDay, 2=WeekNum, 3=Day, 4=Month, 5=Year
+    switch (date_type) {
+      case 0: // Month Name (2 letters)
+        if (s_month >= 1 && s_month <= 12) {
+          date_side->letters = true;
+          date_side->glyphs[0] = (int8_t)month_letters[s_month - 1][0];
+          date_side->glyphs[1] = (int8_t)month_letters[s_month - 1][1];
+        }
+        break;
+      case 1: // Week Day (2 letters)
+        if (s_weekday <= 6) {
+          date_side->letters = true;
+          date_side->glyphs[0] = (int8_t)weekday_letters[s_weekday][0];
+          date_side->glyphs[1] = (int8_t)weekday_letters[s_weekday][1];
+        }
+        break;
+      case 2: value = s_week; break;   // Week of the Year
+      case 3: value = s_day; break;    // Day
+      case 4: value = s_month; break;  // Month (number)
+      case 5: value = s_year; break;   // Year (last 2 digits)
+    }
+    
+    if (value >= 0) {
+      date_side->glyphs[0] = (int8_t)(value / 10);
+      date_side->glyphs[1] = (int8_t)(value % 10);
+    }
+    
+    for (int i = 0; i < 2; i++) {
+      int8_t glyph = date_side->glyphs[i];
+      const uint8_t *pattern = glyph < 0 ? empty_small_pattern :
+          date_side->letters ? small_letter_patterns[glyph] : small_digit_patterns[glyph];
+      widget_morph(&s_date_morphs[side * 2 + i], pattern, MORPH_SECONDARY, s_date_layer, animate);
+    }
+  }
+}
+
+// Date fields change once a day (DAY_UNIT ticks)
+static void update_date(const struct tm *t, bool animate) {
   s_day = (uint8_t)t->tm_mday;
   s_month = (uint8_t)(t->tm_mon + 1);
   s_year = (uint8_t)(t->tm_year % 100);  // Last 2 digits of year
-  
-  // ISO 8601 week calculation
-  // Week 1 is the week with the first Thursday of the year
-  int day_of_week = t->tm_wday == 0 ? 7 : t->tm_wday; // Monday=1, Sunday=7
-  int day_of_year = t->tm_yday + 1; // Make 1-indexed
-  int week_number = (day_of_year - day_of_week + 10) / 7;
-  
-  if (week_number == 0) {
-    // This day belongs to the last week of the previous year
-    week_number = 52; // Simplified - could be 53 in some years
-  } else if (week_number == 53) {
-    // Check if this really belongs to week 1 of next year
-    int jan1_day = (day_of_week - day_of_year % 7 + 7) % 7;
-    if (jan1_day >= 1 && jan1_day <= 3) {
-      week_number = 1;
-    }
-  }
-  
-  s_week = (uint8_t)week_number;
+  s_week = calendar_iso_week(t);
   
   // Store weekday (0=Monday, 6=Sunday)
   s_weekday = t->tm_wday == 0 ? 6 : t->tm_wday - 1;
   
+  update_date_glyphs(animate);
+}
+
+// Hour and minute digits, every minute (animated unless just launched)
+static void update_clock(const struct tm *t, bool animate) {
+  uint8_t new_hour = (uint8_t)t->tm_hour;
+  uint8_t new_minute = (uint8_t)t->tm_min;
+  
   if (!s_flags.use_24h) {
     new_hour = new_hour % 12;
     if (new_hour == 0) new_hour = 12;
   }
   
-  // Check if time digits changed and trigger animations
-  if (s_prev_hour >= 0 && s_prev_minute >= 0) {
-    int old_digits[NUM_DIGITS] = {s_prev_hour / 10, s_prev_hour % 10, s_prev_minute / 10, s_prev_minute % 10};
-    int new_digits[NUM_DIGITS] = {new_hour / 10, new_hour % 10, new_minute / 10, new_minute % 10};
-    
-    bool needs_animation = false;
-    for (int i = 0; i < NUM_DIGITS; i++) {
-      if (old_digits[i] != new_digits[i]) {
-        s_anim_old_digits[i] = old_digits[i];
-        s_anim_new_digits[i] = new_digits[i];
-        s_anim_progress[i] = 0.0f;
-        needs_animation = true;
-      }
-    }
-    
-    if (needs_animation && !s_anim_timer) {
-      s_anim_timer = app_timer_register(ANIM_INTERVAL_MS, animation_timer_callback, NULL);
-    }
-  }
-  
   s_hour = new_hour;
   s_minute = new_minute;
-  s_prev_hour = new_hour;
-  s_prev_minute = new_minute;
+  
+  // Only the digits that changed morph; the hour tens use the secondary color if zero
+  int digits[NUM_DIGITS] = {new_hour / 10, new_hour % 10, new_minute / 10, new_minute % 10};
+  for (int i = 0; i < NUM_DIGITS; i++) {
+    uint8_t flags = (i == 0 && digits[0] == 0) ? MORPH_SECONDARY : 0;
+    widget_morph(&s_time_morphs[i], digit_patterns[digits[i]], flags, s_time_layer, animate);
+  }
   
   // Update step count if health is available
   if (s_flags.health_available) {
-    s_steps = (uint16_t)health_service_sum_today(HealthMetricStepCount);
+    update_steps();
   }
-  
-  layer_mark_dirty(s_canvas_layer);
 }
 
 static void health_handler(HealthEventType event, void *context) {
   if (event == HealthEventMovementUpdate || event == HealthEventSignificantUpdate) {
-    s_steps = (uint16_t)health_service_sum_today(HealthMetricStepCount);
-    layer_mark_dirty(s_canvas_layer);
+    update_steps();
   }
 }
 
 static void battery_handler(BatteryChargeState charge) {
   s_battery_level = (uint8_t)charge.charge_percent;
-  layer_mark_dirty(s_canvas_layer);
+  if (meter_update(&s_battery_meter, battery_level())) {
+    update_battery_cells(s_battery_meter.valid);
+  }
 }
 
-static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
-  update_time();
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+// Tick every second only while the seconds are shown
+static void update_tick_units(void) {
+  TimeUnits units = seconds_shown() ? SECOND_UNIT : MINUTE_UNIT;
+  if (units == s_tick_units) return;
+  s_tick_units = units;
+  tick_timer_service_subscribe(units, tick_handler);
 }
 
-// Load settings from persistent storage
-static void load_settings(void) {
-  // Set defaults
-  s_bg_color = GColorBlack;
-  s_fg_color = GColorWhite;
-  s_secondary_color = GColorLightGray;
-  
-  // Load from persistent storage if available
-  if (persist_exists(PERSIST_KEY_BG_COLOR)) {
-    s_bg_color = (GColor){ .argb = (uint8_t)persist_read_int(PERSIST_KEY_BG_COLOR) };
-  }
-  if (persist_exists(PERSIST_KEY_FG_COLOR)) {
-    s_fg_color = (GColor){ .argb = (uint8_t)persist_read_int(PERSIST_KEY_FG_COLOR) };
-  }
-  if (persist_exists(PERSIST_KEY_SECONDARY_COLOR)) {
-    s_secondary_color = (GColor){ .argb = (uint8_t)persist_read_int(PERSIST_KEY_SECONDARY_COLOR) };
-  }
-  if (persist_exists(PERSIST_KEY_STEP_GOAL)) {
-    s_step_goal = (uint16_t)persist_read_int(PERSIST_KEY_STEP_GOAL);
-  }
-  if (persist_exists(PERSIST_KEY_SHOW_STEPS)) {
-    s_flags.show_steps = persist_read_bool(PERSIST_KEY_SHOW_STEPS);
+// Seconds digits for s_second; a jump draws them in full, otherwise only the
+// cells that changed are swapped in the next frame
+static void update_seconds_cells(bool jump) {
+  int digits[2] = {s_second / 10, s_second % 10};
+  for (int i = 0; i < 2; i++) {
+    if (jump) {
+      morph_set(&s_seconds_morphs[i], small_digit_patterns[digits[i]], MORPH_SECONDARY);
+    } else {
+      morph_start(&s_seconds_morphs[i], small_digit_patterns[digits[i]], MORPH_SECONDARY, 0);
+    }
   }
-  if (persist_exists(PERSIST_KEY_SHOW_BATTERY)) {
-    s_flags.show_battery = persist_read_bool(PERSIST_KEY_SHOW_BATTERY);
+}
+
+// Wake the seconds (drawn into their empty cells) or put them to sleep
+// (a full redraw clears them)
+static void seconds_set_awake(bool awake) {
+  s_seconds_awake = awake;
+  s_seconds_idle = 0;
+  layer_set_hidden(s_seconds_layer, !seconds_shown());
+  update_tick_units();
+  if (awake) {
+    time_t now = time(NULL);
+    s_second = (uint8_t)localtime(&now)->tm_sec;
+    update_seconds_cells(true);
+    s_cells_pending = true;
+    layer_mark_dirty(s_seconds_layer);
+  } else {
+    face_mark_dirty(window_get_root_layer(s_window));
   }
-  if (persist_exists(PERSIST_KEY_SHOW_DATE)) {
-    s_flags.show_date = persist_read_bool(PERSIST_KEY_SHOW_DATE);
+}
+
+// A wrist flick keeps the seconds awake, or wakes them
+static void tap_handler(AccelAxisType axis, int32_t direction) {
+  if (s_seconds_awake) {
+    s_seconds_idle = 0;
+  } else {
+    seconds_set_awake(true);
   }
-  if (persist_exists(PERSIST_KEY_USE_24H)) {
-    s_flags.use_24h = persist_read_bool(PERSIST_KEY_USE_24H);
+}
+
+// Taps only matter while the seconds setting is on
+static void update_seconds_mode(void) {
+  if (s_flags.show_seconds && !s_tap_subscribed) {
+    accel_tap_service_subscribe(tap_handler);
+  } else if (!s_flags.show_seconds && s_tap_subscribed) {
+    accel_tap_service_unsubscribe();
   }
-  if (persist_exists(PERSIST_KEY_DATE_LEFT)) {
-    s_flags.date_left = (uint8_t)persist_read_int(PERSIST_KEY_DATE_LEFT);
+  s_tap_subscribed = s_flags.show_seconds;
+  s_seconds_awake = s_flags.show_seconds;
+  s_seconds_idle = 0;
+  update_seconds_cells(true);
+  layer_set_hidden(s_seconds_layer, !seconds_shown());
+  update_tick_units();
+}
+
+// Seconds tick: only the seconds layer redraws, unless the minute changed too
+static void update_seconds(const struct tm *t) {
+  if (++s_seconds_idle >= SECONDS_IDLE_S) {
+    seconds_set_awake(false);
+    return;
   }
-  if (persist_exists(PERSIST_KEY_DATE_RIGHT)) {
-    s_flags.date_right = (uint8_t)persist_read_int(PERSIST_KEY_DATE_RIGHT);
+  s_second = (uint8_t)t->tm_sec;
+  update_seconds_cells(false);
+  s_cells_pending = true;
+  layer_mark_dirty(s_seconds_layer);
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  if (units_changed & MINUTE_UNIT) {
+    update_clock(tick_time, true);
+    if (tick_time->tm_min == STEP_HISTORY_MINUTE && update_step_history()) {
+      update_step_cells(true);
+    }
   }
-  if (persist_exists(PERSIST_KEY_LOAD_ANIMATION)) {
-    s_load_animation = (uint8_t)persist_read_int(PERSIST_KEY_LOAD_ANIMATION);
+  if (units_changed & DAY_UNIT) {
+    // New day: report how many meter wakeups were spared a redraw
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Steps: %d redraws, %d suppressed; battery: %d redraws, %d suppressed",
+            s_step_meter.redraws, s_step_meter.suppressed,
+            s_battery_meter.redraws, s_battery_meter.suppressed);
+    meter_reset_counts(&s_step_meter);
+    meter_reset_counts(&s_battery_meter);
+    update_date(tick_time, true);
   }
-  if (persist_exists(PERSIST_KEY_SHOW_WEATHER)) {
-    s_flags.show_weather = persist_read_bool(PERSIST_KEY_SHOW_WEATHER);
+  if (units_changed & HOUR_UNIT) {
+    PROFILE_LOG();
   }
-  if (persist_exists(PERSIST_KEY_WEATHER_UNIT)) {
-    s_flags.weather_use_fahrenheit = persist_read_bool(PERSIST_KEY_WEATHER_UNIT);
+  if (s_tick_units == SECOND_UNIT) {
+    update_seconds(tick_time);
   }
-  if (persist_exists(PERSIST_KEY_SHOW_CORNERS)) {
-    s_flags.show_corners = persist_read_bool(PERSIST_KEY_SHOW_CORNERS);
+}
+
+static uint8_t settings_flag(bool value, uint8_t flag) {
+  return value ? flag : 0;
+}
+
+// Pack the current settings for storage
+static void settings_to_blob(SettingsBlob *blob) {
+  *blob = (SettingsBlob){
+    .version = SETTINGS_VERSION,
+    .bg_color = s_bg_color.argb,
+    .fg_color = s_fg_color.argb,
+    .secondary_color = s_secondary_color.argb,
+    .step_goal = s_step_goal,
+    .load_animation = s_load_animation,
+    .date_left = s_flags.date_left,
+    .date_right = s_flags.date_right,
+    .flags = settings_flag(s_flags.show_steps, SETTINGS_FLAG_SHOW_STEPS) |
+             settings_flag(s_flags.show_battery, SETTINGS_FLAG_SHOW_BATTERY) |
+             settings_flag(s_flags.show_date, SETTINGS_FLAG_SHOW_DATE) |
+             settings_flag(s_flags.use_24h, SETTINGS_FLAG_USE_24H) |
+             settings_flag(s_flags.show_weather, SETTINGS_FLAG_SHOW_WEATHER) |
+             settings_flag(s_flags.weather_use_fahrenheit, SETTINGS_FLAG_FAHRENHEIT) |
+             settings_flag(s_flags.show_corners, SETTINGS_FLAG_SHOW_CORNERS) |
+             settings_flag(s_flags.show_seconds, SETTINGS_FLAG_SHOW_SECONDS),
+    .step_display = s_flags.step_history,
+  };
+}
+
+static void settings_from_blob(const SettingsBlob *blob) {
+  s_bg_color = (GColor){ .argb = blob->bg_color };
+  s_fg_color = (GColor){ .argb = blob->fg_color };
+  s_secondary_color = (GColor){ .argb = blob->secondary_color };
+  s_step_goal = blob->step_goal;
+  if (s_step_goal < 1000) s_step_goal = 1000;
+  if (s_step_goal > 50000) s_step_goal = 50000;
+  s_load_animation = blob->load_animation <= 3 ? blob->load_animation : 0;
+  if (blob->date_left <= 5) s_flags.date_left = blob->date_left;
+  if (blob->date_right <= 5) s_flags.date_right = blob->date_right;
+  s_flags.show_steps = (blob->flags & SETTINGS_FLAG_SHOW_STEPS) != 0;
+  s_flags.show_battery = (blob->flags & SETTINGS_FLAG_SHOW_BATTERY) != 0;
+  s_flags.show_date = (blob->flags & SETTINGS_FLAG_SHOW_DATE) != 0;
+  s_flags.use_24h = (blob->flags & SETTINGS_FLAG_USE_24H) != 0;
+  s_flags.show_weather = (blob->flags & SETTINGS_FLAG_SHOW_WEATHER) != 0;
+  s_flags.weather_use_fahrenheit = (blob->flags & SETTINGS_FLAG_FAHRENHEIT) != 0;
+  s_flags.show_corners = (blob->flags & SETTINGS_FLAG_SHOW_CORNERS) != 0;
+  s_flags.show_seconds = (blob->flags & SETTINGS_FLAG_SHOW_SECONDS) != 0;
+  s_flags.step_history = blob->step_display == 1;
+}
+
+// Load settings from persistent storage
+static void load_settings(void) {
+  // Set defaults
+  s_bg_color = GColorBlack;
+  s_fg_color = GColorWhite;
+  s_secondary_color = GColorLightGray;
+  
+  // One read of the settings blob over the defaults
+  SettingsBlob blob;
+  settings_to_blob(&blob);
+  if (settings_load(&blob)) {
+    settings_from_blob(&blob);
   }
 }
 
-// Save settings to persistent storage
+// Save settings to persistent storage (deferred, skipped if unchanged)
 static void save_settings(void) {
-  persist_write_int(PERSIST_KEY_BG_COLOR, s_bg_color.argb);
-  persist_write_int(PERSIST_KEY_FG_COLOR, s_fg_color.argb);
-  persist_write_int(PERSIST_KEY_SECONDARY_COLOR, s_secondary_color.argb);
-  persist_write_int(PERSIST_KEY_STEP_GOAL, s_step_goal);
-  persist_write_bool(PERSIST_KEY_SHOW_STEPS, s_flags.show_steps);
-  persist_write_bool(PERSIST_KEY_SHOW_BATTERY, s_flags.show_battery);
-  persist_write_bool(PERSIST_KEY_SHOW_DATE, s_flags.show_date);
-  persist_write_bool(PERSIST_KEY_USE_24H, s_flags.use_24h);
-  persist_write_int(PERSIST_KEY_DATE_LEFT, s_flags.date_left);
-  persist_write_int(PERSIST_KEY_DATE_RIGHT, s_flags.date_right);
-  persist_write_int(PERSIST_KEY_LOAD_ANIMATION, s_load_animation);
-  persist_write_bool(PERSIST_KEY_SHOW_WEATHER, s_flags.show_weather);
-  persist_write_bool(PERSIST_KEY_WEATHER_UNIT, s_flags.weather_use_fahrenheit);
-  persist_write_bool(PERSIST_KEY_SHOW_CORNERS, s_flags.show_corners);
+  SettingsBlob blob;
+  settings_to_blob(&blob);
+  settings_save(&blob);
 }
 
 // AppMessage inbox received handler
 static void inbox_received_handler(DictionaryIterator *iter, void *context) {
-  // Background color
-  Tuple *bg_t = dict_find(iter, MESSAGE_KEY_BACKGROUND_COLOR);
-  if (bg_t) {
-    s_bg_color = GColorFromHEX(bg_t->value->int32);
-  }
-  
-  // Foreground color
-  Tuple *fg_t = dict_find(iter, MESSAGE_KEY_FOREGROUND_COLOR);
-  if (fg_t) {
-    s_fg_color = GColorFromHEX(fg_t->value->int32);
-  }
-  
-  // Secondary color
-  Tuple *sec_t = dict_find(iter, MESSAGE_KEY_SECONDARY_COLOR);
-  if (sec_t) {
-    s_secondary_color = GColorFromHEX(sec_t->value->int32);
-  }
-  
-  // Step goal
-  Tuple *goal_t = dict_find(iter, MESSAGE_KEY_STEP_GOAL);
-  if (goal_t) {
-    s_step_goal = atoi(goal_t->value->cstring);
-    if (s_step_goal < 1000) s_step_goal = 1000;
-    if (s_step_goal > 50000) s_step_goal = 50000;
-  }
-  
-  // Show steps
-  Tuple *steps_t = dict_find(iter, MESSAGE_KEY_SHOW_STEPS);
-  if (steps_t) {
-    s_flags.show_steps = steps_t->value->int32 == 1;
-  }
-  
-  // Show battery
-  Tuple *batt_t = dict_find(iter, MESSAGE_KEY_SHOW_BATTERY);
-  if (batt_t) {
-    s_flags.show_battery = batt_t->value->int32 == 1;
-  }
-  
-  // Show date
-  Tuple *date_t = dict_find(iter, MESSAGE_KEY_SHOW_DATE);
-  if (date_t) {
-    s_flags.show_date = date_t->value->int32 == 1;
-  }
-  
-  // Use 24-hour format
-  Tuple *hour_t = dict_find(iter, MESSAGE_KEY_USE_24_HOUR);
-  if (hour_t) {
-    s_flags.use_24h = hour_t->value->int32 == 1;
-  }
-  
-  // Date left side
-  Tuple *date_left_t = dict_find(iter, MESSAGE_KEY_DATE_LEFT);
-  if (date_left_t) {
-    int val = atoi(date_left_t->value->cstring);
-    if (val >= 0 && val <= 5) s_flags.date_left = (uint8_t)val;
-  }
-  
-  // Date right side
-  Tuple *date_right_t = dict_find(iter, MESSAGE_KEY_DATE_RIGHT);
-  if (date_right_t) {
-    int val = atoi(date_right_t->value->cstring);
-    if (val >= 0 && val <= 5) s_flags.date_right = (uint8_t)val;
-  }
-  
-  // Load animation
-  Tuple *anim_t = dict_find(iter, MESSAGE_KEY_LOAD_ANIMATION);
-  if (anim_t) {
-    int anim_val = atoi(anim_t->value->cstring);
-    if (anim_val < 0) anim_val = 0;
-    if (anim_val > 3) anim_val = 3;
-    s_load_animation = (uint8_t)anim_val;
-  }
-  
-  // Show weather
-  Tuple *weather_t = dict_find(iter, MESSAGE_KEY_SHOW_WEATHER);
-  if (weather_t) {
-    s_flags.show_weather = weather_t->value->int32 == 1;
-  }
-  
   // Weather temperature (always in Celsius)
   Tuple *temp_t = dict_find(iter, MESSAGE_KEY_WEATHER_TEMPERATURE);
   if (temp_t) {
     s_weather_temp = (int16_t)temp_t->value->int32;
+    update_weather(true);
   }
   
-  // Show corners
-  Tuple *corners_t = dict_find(iter, MESSAGE_KEY_SHOW_CORNERS);
-  if (corners_t) {
-    s_flags.show_corners = corners_t->value->int32 == 1;
-  }
-  
-  // Weather unit (C or F)
-  Tuple *unit_t = dict_find(iter, MESSAGE_KEY_WEATHER_UNIT);
-  if (unit_t) {
-    s_flags.weather_use_fahrenheit = (strcmp(unit_t->value->cstring, "F") == 0);
+  // Settings, packed as a SettingsBlob byte array
+  Tuple *settings_t = dict_find(iter, MESSAGE_KEY_SETTINGS);
+  if (!settings_t || settings_t->type != TUPLE_BYTE_ARRAY) return;
+  
+  SettingsBlob blob;
+  settings_to_blob(&blob);
+  if (!settings_decode(&blob, settings_t->value->data, settings_t->length)) return;
+  bool had_history = s_flags.step_history;
+  settings_from_blob(&blob);
+  update_date_glyphs(false);
+  update_weather(false);
+  
+  // The history view reads only the hours it misses; the bar needs the
+  // day's total again after it
+  if (!update_step_history() && had_history && s_flags.health_available) {
+    update_steps();
   }
+  update_step_cells(false);
   
   // Save and update
   save_settings();
-  window_set_background_color(s_window, s_bg_color);
-  layer_mark_dirty(s_canvas_layer);
+  update_layout();
+  update_seconds_mode();
+  face_mark_dirty(window_get_root_layer(s_window));
+}
+
+// Create a widget layer and add it to the window
+static Layer *widget_layer_create(Layer *parent, LayerUpdateProc update_proc) {
+  Layer *layer = layer_create(GRectZero);
+  layer_set_update_proc(layer, update_proc);
+  layer_add_child(parent, layer);
+  return layer;
 }
 
 static void prv_window_load(Window *window) {
@@ -1007,66 +1376,172 @@ static void prv_window_load(Window *window) {
   s_grid_rows = bounds.size.h / CELL_SIZE;
   s_grid_offset_x = (bounds.size.w - s_grid_cols * CELL_SIZE) / 2;
   s_grid_offset_y = (bounds.size.h - s_grid_rows * CELL_SIZE) / 2;
+  s_short_rows = visible_rows();
+#ifdef PBL_ROUND
+  grid_spans_build(s_grid_spans, s_grid_cols, s_grid_rows,
+                   s_grid_offset_x, s_grid_offset_y, bounds.size);
+#endif
+  
+  // Morph buffers; the step bar sweeps along its diagonals
+  for (int i = 0; i < NUM_DIGITS; i++) {
+    morph_init(&s_time_morphs[i], s_time_cells[i], 5, 7, NULL, 0);
+  }
+  for (int i = 0; i < DATE_GLYPHS; i++) {
+    morph_init(&s_date_morphs[i], s_date_cells[i], 3, 5, NULL, 0);
+  }
+  for (int i = 0; i < WEATHER_DIGITS; i++) {
+    morph_init(&s_weather_morphs[i], s_weather_cells[i], 3, 5, NULL, 0);
+  }
+  for (int i = 0; i < 2; i++) {
+    morph_init(&s_seconds_morphs[i], s_seconds_cells[i], 3, 5, NULL, 0);
+  }
+  uint8_t step_values[STEP_BAR_CELLS];
+  step_bar_cells((MeterLevel){0}, step_values, s_step_ranks);
+  morph_init(&s_step_morph, s_step_cells, 15, 5, s_step_ranks, 19);
+  morph_init(&s_battery_morph, s_battery_cells, 2, 3, NULL, 0);
+  
+  // Background fill, skipped in partial frames
+  s_background_layer = widget_layer_create(window_layer, background_update_proc);
+  layer_set_frame(s_background_layer, bounds);
+  
+  // Widget layers in drawing order; frames are set by update_layout()
+  s_weather_layer = widget_layer_create(window_layer, weather_update_proc);
+  s_step_layer = widget_layer_create(window_layer, step_update_proc);
+  s_battery_layer = widget_layer_create(window_layer, battery_update_proc);
+  s_time_layer = widget_layer_create(window_layer, time_update_proc);
+  s_date_layer = widget_layer_create(window_layer, date_update_proc);
+  s_corners_layer = widget_layer_create(window_layer, corners_update_proc);
+  s_face_cache_layer = widget_layer_create(window_layer, face_cache_update_proc);
+  s_seconds_layer = widget_layer_create(window_layer, seconds_update_proc);
+  frame_clock_client_init(&s_morph_clock, morph_clock_step, NULL, NULL, MORPH_CLOCK_DIVIDER);
+  layer_set_frame(s_corners_layer, bounds);
+  layer_set_frame(s_face_cache_layer, bounds);
+  update_layout();
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+    .will_change = unobstructed_will_change,
+    .change = unobstructed_change,
+    .did_change = unobstructed_did_change,
+  }, NULL);
+#endif
+  
+  // Glyphs fall back to per-cell drawing if a set doesn't fit in memory
+  glyph_set_create(&s_digit_glyphs, digit_patterns[0], 10, 5, 7);
+  glyph_set_create(&s_small_digit_glyphs, small_digit_patterns[0], 10, 3, 5);
+  glyph_set_create(&s_letter_glyphs, small_letter_patterns[0], 19, 3, 5);
+  
+  // Load animation draws over the whole face
+  s_anim_layer = layer_create(bounds);
+  layer_set_update_proc(s_anim_layer, anim_update_proc);
+  layer_add_child(window_layer, s_anim_layer);
   
-  s_canvas_layer = layer_create(bounds);
-  layer_set_update_proc(s_canvas_layer, canvas_update_proc);
-  layer_add_child(window_layer, s_canvas_layer);
+#ifdef GRIDSPACE_PROFILE
+  s_profile_layer = widget_layer_create(window_layer, profile_update_proc);
+  layer_set_frame(s_profile_layer, grid_rect(0, 0, s_grid_cols, s_grid_rows));
+#endif
   
   // Initialize and start load animation based on setting
   animations_init(&s_load_anim);
-  s_load_anim.layer = s_canvas_layer;
+  s_load_anim.layer = s_anim_layer;
   
   if (s_load_animation == 1) {
-    animations_start_load(&s_load_anim, ANIM_WAVE_FILL);
+    animations_start_load(&s_load_anim, ANIM_WAVE_FILL, s_grid_cols, s_grid_rows, GRID_SPANS);
   } else if (s_load_animation == 2) {
-    animations_start_load(&s_load_anim, ANIM_RANDOM_POP);
+    animations_start_load(&s_load_anim, ANIM_RANDOM_POP, s_grid_cols, s_grid_rows, GRID_SPANS);
   } else if (s_load_animation == 3) {
-    animations_start_load(&s_load_anim, ANIM_MATRIX);
+    animations_start_load(&s_load_anim, ANIM_MATRIX, s_grid_cols, s_grid_rows, GRID_SPANS);
   }
   // If s_load_animation == 0, don't start any animation
   
-  update_time();
+  time_t now = time(NULL);
+  struct tm *t = localtime(&now);
+  update_clock(t, false);
+  update_date(t, false);
+  update_weather(false);
+  update_step_cells(false);
+  update_battery_cells(false);
+}
+
+// Another window may have drawn over the face
+static void prv_window_appear(Window *window) {
+  s_face_dirty = true;
 }
 
 static void prv_window_unload(Window *window) {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  unobstructed_area_service_unsubscribe();
+#endif
   animations_stop(&s_load_anim);
-  layer_destroy(s_canvas_layer);
+  frame_clock_stop(&s_morph_clock);
+#ifdef GRIDSPACE_PROFILE
+  layer_destroy(s_profile_layer);
+#endif
+  layer_destroy(s_anim_layer);
+  layer_destroy(s_seconds_layer);
+  layer_destroy(s_face_cache_layer);
+  layer_destroy(s_corners_layer);
+  layer_destroy(s_date_layer);
+  layer_destroy(s_time_layer);
+  layer_destroy(s_battery_layer);
+  layer_destroy(s_step_layer);
+  layer_destroy(s_weather_layer);
+  layer_destroy(s_background_layer);
+  face_cache_destroy(&s_face_cache);
+  glyph_set_destroy(&s_letter_glyphs);
+  glyph_set_destroy(&s_small_digit_glyphs);
+  glyph_set_destroy(&s_digit_glyphs);
 }
 
 static void prv_init(void) {
+#ifdef GRIDSPACE_SEED
+  // Same load animation cells every launch, for comparing timings
+  animations_set_seed(GRIDSPACE_SEED);
+#endif
   // Load saved settings
   load_settings();
   
   s_window = window_create();
-  window_set_background_color(s_window, s_bg_color);
+  // The background layer fills the window, so partial frames can keep it
+  window_set_background_color(s_window, GColorClear);
   window_set_window_handlers(s_window, (WindowHandlers) {
     .load = prv_window_load,
+    .appear = prv_window_appear,
     .unload = prv_window_unload,
   });
   window_stack_push(s_window, true);
-  tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+  update_seconds_mode();
   
   // Subscribe to battery service
   battery_state_service_subscribe(battery_handler);
   s_battery_level = (uint8_t)battery_state_service_peek().charge_percent;
+  update_battery_cells(false);
   
   // Subscribe to health only if available
   s_flags.health_available = health_service_events_subscribe(health_handler, NULL);
+  if (s_flags.health_available) {
+    step_history_load(&s_step_history);
+    if (update_step_history()) update_step_cells(false);
+  }
+  update_layout();
   
   // Open AppMessage for settings
   app_message_register_inbox_received(inbox_received_handler);
-  app_message_open(128, 64);
+  app_message_open(MESSAGE_INBOX_SIZE, MESSAGE_OUTBOX_SIZE);
 }
 
 static void prv_deinit(void) {
-  if (s_anim_timer) {
-    app_timer_cancel(s_anim_timer);
-  }
+  settings_flush();
+  PROFILE_LOG();
   if (s_flags.health_available) {
     health_service_events_unsubscribe();
   }
   battery_state_service_unsubscribe();
   tick_timer_service_unsubscribe();
+  s_tick_units = 0;
+  if (s_tap_subscribed) {
+    accel_tap_service_unsubscribe();
+    s_tap_subscribed = false;
+  }
   window_destroy(s_window);
 }
 
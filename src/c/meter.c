@@ -0,0 +1,34 @@
+#include "meter.h"
+
+MeterLevel meter_level(uint32_t value, uint32_t max, uint8_t cells) {
+  MeterLevel level = {.filled = cells, .partial = false};
+  if (max == 0) return level;
+  
+  uint32_t scaled = value * cells;
+  if (scaled / max < cells) {
+    level.filled = (uint8_t)(scaled / max);
+    level.partial = (scaled % max) > 0;
+  }
+  return level;
+}
+
+bool meter_update(Meter *meter, MeterLevel level) {
+  bool changed = !meter->valid ||
+                 level.filled != meter->drawn.filled || level.partial != meter->drawn.partial;
+  if (changed) {
+    meter->redraws++;
+  } else {
+    meter->suppressed++;
+  }
+  return changed;
+}
+
+void meter_drawn(Meter *meter, MeterLevel level) {
+  meter->drawn = level;
+  meter->valid = true;
+}
+
+void meter_reset_counts(Meter *meter) {
+  meter->redraws = 0;
+  meter->suppressed = 0;
+}
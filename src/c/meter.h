@@ -0,0 +1,29 @@
+#pragma once
+#include <pebble.h>
+
+// Visual state of a cell meter (step bar, battery): the number of filled
+// cells and whether the next cell shows a partial fill. Values that map to
+// the same level draw the same pixels.
+typedef struct {
+  uint8_t filled;
+  bool partial;
+} MeterLevel;
+
+typedef struct {
+  MeterLevel drawn;     // Level at the last draw
+  bool valid;           // False until the first draw
+  uint16_t redraws;     // Updates today that changed the level
+  uint16_t suppressed;  // Updates today that left it unchanged
+} Meter;
+
+// Quantize value out of max onto a meter of `cells` cells
+MeterLevel meter_level(uint32_t value, uint32_t max, uint8_t cells);
+
+// Record a data update; returns true if it changes what the meter shows
+bool meter_update(Meter *meter, MeterLevel level);
+
+// Record the level a draw actually used
+void meter_drawn(Meter *meter, MeterLevel level);
+
+// Start a new day of counts
+void meter_reset_counts(Meter *meter);
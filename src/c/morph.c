@@ -0,0 +1,103 @@
+#include "morph.h"
+#include "grid.h"
+#include <string.h>
+
+// Drawn progress while the old cells are on screen, and when nothing known is
+#define MORPH_FROM ((fixed_t)-1)
+#define MORPH_UNDRAWN INT32_MIN
+
+static inline uint8_t prv_pack(uint8_t value, uint8_t flags) {
+  return value != CELL_EMPTY ? (uint8_t)(value | flags) : CELL_EMPTY;
+}
+
+static inline fixed_t prv_progress(const CellMorph *morph) {
+  return ease_in_out(timeline_progress(&morph->timeline));
+}
+
+// On the sweep line a full cell that appears, disappears or changes size
+// passes through a partial stamp; anything else shows the new cell
+static uint8_t prv_sweep_value(uint8_t from, uint8_t to) {
+  uint8_t from_state = from & MORPH_STATE_MASK;
+  uint8_t to_state = to & MORPH_STATE_MASK;
+  if (from_state == to_state || (from_state != CELL_FULL && to_state != CELL_FULL)) return to;
+  uint8_t color = (to_state != CELL_EMPTY ? to : from) & MORPH_SECONDARY;
+  return (uint8_t)(CELL_PARTIAL | color);
+}
+
+// Rank k of n is on the sweep line while progress * n is in [k, k + 1)
+static uint8_t prv_value(const CellMorph *morph, int index, fixed_t progress) {
+  uint8_t from = morph->cells[index];
+  uint8_t to = morph->cells[morph_cell_count(morph) + index];
+  if (progress < 0) return from;
+  if (from == to) return to;
+  
+  int rank = morph->ranks ? morph->ranks[index] : index / morph->cols;
+  int64_t sweep = (int64_t)progress * morph->rank_count;
+  if (sweep < (int64_t)rank * FIXED_ONE) return from;
+  if (sweep >= (int64_t)(rank + 1) * FIXED_ONE) return to;
+  return prv_sweep_value(from, to);
+}
+
+void morph_init(CellMorph *morph, uint8_t *buffer, uint8_t cols, uint8_t rows,
+                const uint8_t *ranks, uint8_t rank_count) {
+  memset(buffer, 0, 2 * cols * rows);
+  *morph = (CellMorph){
+    .cells = buffer,
+    .ranks = ranks,
+    .cols = cols,
+    .rows = rows,
+    .rank_count = ranks ? rank_count : rows,
+    .drawn = MORPH_UNDRAWN,
+  };
+}
+
+void morph_set(CellMorph *morph, const uint8_t *values, uint8_t flags) {
+  int count = morph_cell_count(morph);
+  for (int i = 0; i < count; i++) {
+    morph->cells[i] = morph->cells[count + i] = prv_pack(values[i], flags);
+  }
+  timeline_finish(&morph->timeline);
+  morph->drawn = MORPH_UNDRAWN;
+}
+
+bool morph_start(CellMorph *morph, const uint8_t *values, uint8_t flags, uint16_t duration_ms) {
+  int count = morph_cell_count(morph);
+  uint8_t *to = morph->cells + count;
+  int i = 0;
+  while (i < count && to[i] == prv_pack(values[i], flags)) i++;
+  if (i == count) return false;
+  
+  // Whatever shows now (possibly mid-morph) becomes the old cells
+  fixed_t progress = prv_progress(morph);
+  for (i = 0; i < count; i++) {
+    morph->cells[i] = prv_value(morph, i, progress);
+    to[i] = prv_pack(values[i], flags);
+  }
+  morph->drawn = morph->drawn == progress ? MORPH_FROM : MORPH_UNDRAWN;
+  timeline_start(&morph->timeline, duration_ms);
+  return true;
+}
+
+uint8_t morph_cell(const CellMorph *morph, int index) {
+  return prv_value(morph, index, prv_progress(morph));
+}
+
+uint8_t morph_drawn_cell(const CellMorph *morph, int index) {
+  if (morph->drawn == MORPH_UNDRAWN) return MORPH_UNKNOWN;
+  return prv_value(morph, index, morph->drawn);
+}
+
+int morph_next_change(const CellMorph *morph, int index) {
+  int count = morph_cell_count(morph);
+  if (morph->drawn == MORPH_UNDRAWN) return index < count ? index : -1;
+  fixed_t progress = prv_progress(morph);
+  if (progress == morph->drawn) return -1;
+  for (; index < count; index++) {
+    if (prv_value(morph, index, progress) != prv_value(morph, index, morph->drawn)) return index;
+  }
+  return -1;
+}
+
+void morph_mark_drawn(CellMorph *morph) {
+  morph->drawn = prv_progress(morph);
+}
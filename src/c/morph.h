@@ -0,0 +1,64 @@
+#pragma once
+#include <pebble.h>
+#include "timeline.h"
+
+// Animated change between two grids of cell values (cols x rows, row-major):
+// bits 0-1 cell state, bit 2 secondary color. Each cell has a rank, and a
+// sweep over the ranks (eased, in integer math) turns old cells into new
+// ones; the cell on the sweep line shows a partial stamp. The morph tracks
+// the progress it was last drawn at, so a frame can redraw only the cells
+// that changed since.
+#define MORPH_STATE_MASK 0x03
+#define MORPH_SECONDARY 0x04
+// Drawn value of a cell whose pixels are unknown
+#define MORPH_UNKNOWN 0xff
+
+typedef struct {
+  uint8_t *cells;          // From values, then to values (2 * cols * rows)
+  const uint8_t *ranks;    // Sweep order per cell, NULL for top to bottom
+  uint8_t cols;
+  uint8_t rows;
+  uint8_t rank_count;
+  Timeline timeline;
+  fixed_t drawn;           // Eased progress on screen (see morph.c)
+} CellMorph;
+
+static inline int morph_cell_count(const CellMorph *morph) {
+  return morph->cols * morph->rows;
+}
+
+// Set up a morph over a caller-owned buffer of 2 * cols * rows bytes; it
+// starts out empty and undrawn. Ranks go from 0 to rank_count - 1.
+void morph_init(CellMorph *morph, uint8_t *buffer, uint8_t cols, uint8_t rows,
+                const uint8_t *ranks, uint8_t rank_count);
+
+// Jump to new cell values without animating; every cell redraws.
+// Non-empty cells get `flags` (MORPH_SECONDARY) added, so plain glyph
+// patterns can be passed in.
+void morph_set(CellMorph *morph, const uint8_t *values, uint8_t flags);
+
+// Animate from what is on screen now to new cell values over duration_ms
+// (0 swaps them in the next frame). Returns false if the target is unchanged.
+bool morph_start(CellMorph *morph, const uint8_t *values, uint8_t flags, uint16_t duration_ms);
+
+static inline void morph_step(CellMorph *morph, uint16_t ms) {
+  timeline_advance(&morph->timeline, ms);
+}
+
+static inline bool morph_running(const CellMorph *morph) {
+  return !timeline_done(&morph->timeline);
+}
+
+// Cell value at the current progress
+uint8_t morph_cell(const CellMorph *morph, int index);
+
+// Cell value as last drawn, MORPH_UNKNOWN if the morph was never drawn or
+// jumped since
+uint8_t morph_drawn_cell(const CellMorph *morph, int index);
+
+// First cell at or after index whose value differs from the drawn one, or
+// -1 if there is none
+int morph_next_change(const CellMorph *morph, int index);
+
+// The current progress is on screen
+void morph_mark_drawn(CellMorph *morph);
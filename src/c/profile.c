@@ -0,0 +1,86 @@
+#include "profile.h"
+#include "wall_clock.h"
+#include <string.h>
+
+#ifdef GRIDSPACE_PROFILE
+
+static ProfileStats s_stats;
+static uint32_t s_frame_start_ms;
+static uint32_t s_widget_start_ms;
+static bool s_in_frame;
+
+static const char *s_widget_names[PROFILE_WIDGET_COUNT] = {
+  "weather", "steps", "battery", "time", "date", "seconds", "corners", "anim",
+};
+
+static void prv_reset(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_stats.start_s = (uint32_t)time(NULL);
+}
+
+void profile_widget_begin(ProfileWidget widget) {
+  if (s_stats.start_s == 0) prv_reset();
+  s_widget_start_ms = wall_clock_ms();
+  if (!s_in_frame) {
+    s_frame_start_ms = s_widget_start_ms;
+    s_in_frame = true;
+  }
+}
+
+void profile_widget_end(ProfileWidget widget) {
+  s_stats.widget_ms[widget] += wall_clock_ms() - s_widget_start_ms;
+}
+
+void profile_frame_end(void) {
+  if (!s_in_frame) return;
+  s_in_frame = false;
+  
+  uint32_t cost = wall_clock_ms() - s_frame_start_ms;
+  s_stats.frames++;
+  s_stats.frame_ms += cost;
+  s_stats.last_frame_ms = (uint16_t)cost;
+  if (cost > s_stats.max_frame_ms) s_stats.max_frame_ms = (uint16_t)cost;
+  
+  uint32_t used = (uint32_t)heap_bytes_used();
+  if (used > s_stats.heap_used_peak) s_stats.heap_used_peak = used;
+}
+
+void profile_count_cells(uint32_t count) {
+  s_stats.cells += count;
+}
+
+void profile_count_fill_rect(void) {
+  s_stats.fill_rects++;
+}
+
+void profile_count_color_change(void) {
+  s_stats.color_changes++;
+}
+
+void profile_count_wakeup(void) {
+  s_stats.wakeups++;
+}
+
+void profile_log(void) {
+  uint32_t frames = s_stats.frames > 0 ? s_stats.frames : 1;
+  uint32_t elapsed_s = (uint32_t)time(NULL) - s_stats.start_s;
+  uint32_t wakeups_per_hour = elapsed_s > 0 ? s_stats.wakeups * 3600 / elapsed_s : s_stats.wakeups;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Profile: %d frames, %d ms avg, %d ms max, %d cells, %d fill_rects, %d colors per frame",
+          (int)s_stats.frames, (int)(s_stats.frame_ms / frames), s_stats.max_frame_ms,
+          (int)(s_stats.cells / frames), (int)(s_stats.fill_rects / frames),
+          (int)(s_stats.color_changes / frames));
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Profile: %d wakeups/h, heap %d used (peak %d), %d free",
+          (int)wakeups_per_hour, (int)heap_bytes_used(), (int)s_stats.heap_used_peak,
+          (int)heap_bytes_free());
+  for (int i = 0; i < PROFILE_WIDGET_COUNT; i++) {
+    if (s_stats.widget_ms[i] == 0) continue;
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Profile: %s %d ms total", s_widget_names[i], (int)s_stats.widget_ms[i]);
+  }
+  prv_reset();
+}
+
+const ProfileStats *profile_stats(void) {
+  return &s_stats;
+}
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <pebble.h>
+
+// Render profiling, compiled in with -DGRIDSPACE_PROFILE (GRIDSPACE_PROFILE=1
+// pebble build). Records per-frame draw time, per-widget cost, fill/color
+// counts, timer wakeups and heap use, logged hourly with APP_LOG. With
+// GRIDSPACE_PROFILE_OVERLAY the numbers are also drawn over the face.
+// Without the flag every hook below expands to nothing.
+
+#ifdef GRIDSPACE_PROFILE_OVERLAY
+  #ifndef GRIDSPACE_PROFILE
+    #define GRIDSPACE_PROFILE
+  #endif
+#endif
+
+// Layers timed separately
+typedef enum {
+  PROFILE_WEATHER,
+  PROFILE_STEPS,
+  PROFILE_BATTERY,
+  PROFILE_TIME,
+  PROFILE_DATE,
+  PROFILE_SECONDS,
+  PROFILE_CORNERS,
+  PROFILE_ANIMATION,
+  PROFILE_WIDGET_COUNT,
+} ProfileWidget;
+
+#ifdef GRIDSPACE_PROFILE
+
+typedef struct {
+  uint32_t frames;
+  uint32_t frame_ms;       // Total draw time (time_ms resolution)
+  uint16_t last_frame_ms;
+  uint16_t max_frame_ms;
+  uint32_t widget_ms[PROFILE_WIDGET_COUNT];
+  uint32_t cells;          // Cells written straight into the framebuffer
+  uint32_t fill_rects;     // Cells drawn with the fill_rect fallback
+  uint32_t color_changes;
+  uint32_t wakeups;        // AppTimer callbacks
+  uint32_t heap_used_peak;
+  uint32_t start_s;        // Start of the counting period
+} ProfileStats;
+
+void profile_widget_begin(ProfileWidget widget);
+void profile_widget_end(ProfileWidget widget);
+// Close the frame opened by the first widget; call from the top layer
+void profile_frame_end(void);
+void profile_count_cells(uint32_t count);
+void profile_count_fill_rect(void);
+void profile_count_color_change(void);
+void profile_count_wakeup(void);
+// Log the period's summary and start a new one
+void profile_log(void);
+const ProfileStats *profile_stats(void);
+
+#define PROFILE_WIDGET_BEGIN(widget) profile_widget_begin(widget)
+#define PROFILE_WIDGET_END(widget) profile_widget_end(widget)
+#define PROFILE_FRAME_END() profile_frame_end()
+#define PROFILE_CELLS(count) profile_count_cells(count)
+#define PROFILE_FILL_RECT() profile_count_fill_rect()
+#define PROFILE_COLOR_CHANGE() profile_count_color_change()
+#define PROFILE_WAKEUP() profile_count_wakeup()
+#define PROFILE_LOG() profile_log()
+
+#else
+
+#define PROFILE_WIDGET_BEGIN(widget)
+#define PROFILE_WIDGET_END(widget)
+#define PROFILE_FRAME_END()
+#define PROFILE_CELLS(count)
+#define PROFILE_FILL_RECT()
+#define PROFILE_COLOR_CHANGE()
+#define PROFILE_WAKEUP()
+#define PROFILE_LOG()
+
+#endif
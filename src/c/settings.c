@@ -0,0 +1,132 @@
+#include "settings.h"
+#include "profile.h"
+
+#define PERSIST_KEY_SETTINGS 20
+
+// Old layout: one key per setting (versions before the settings blob)
+#define PERSIST_KEY_BG_COLOR 1
+#define PERSIST_KEY_FG_COLOR 2
+#define PERSIST_KEY_SECONDARY_COLOR 3
+#define PERSIST_KEY_STEP_GOAL 4
+#define PERSIST_KEY_SHOW_STEPS 5
+#define PERSIST_KEY_SHOW_BATTERY 6
+#define PERSIST_KEY_SHOW_DATE 7
+#define PERSIST_KEY_USE_24H 8
+#define PERSIST_KEY_DATE_LEFT 9
+#define PERSIST_KEY_DATE_RIGHT 10
+#define PERSIST_KEY_LOAD_ANIMATION 11
+#define PERSIST_KEY_SHOW_WEATHER 12
+#define PERSIST_KEY_WEATHER_UNIT 13
+#define PERSIST_KEY_SHOW_CORNERS 14
+
+// Settings messages tend to arrive in bursts (Clay splits them)
+#define SETTINGS_COMMIT_MS 2000
+
+static SettingsBlob s_stored;       // What is in storage
+static bool s_stored_valid = false;
+static SettingsBlob s_pending;      // Waiting for the commit timer
+static AppTimer *s_commit_timer = NULL;
+
+static void prv_write(const SettingsBlob *blob) {
+  persist_write_data(PERSIST_KEY_SETTINGS, blob, sizeof(*blob));
+  s_stored = *blob;
+  s_stored_valid = true;
+}
+
+static void prv_migrate_flag(SettingsBlob *blob, uint32_t key, uint8_t flag) {
+  if (!persist_exists(key)) return;
+  if (persist_read_bool(key)) {
+    blob->flags |= flag;
+  } else {
+    blob->flags &= ~flag;
+  }
+}
+
+static void prv_migrate_byte(uint8_t *field, uint32_t key) {
+  if (persist_exists(key)) {
+    *field = (uint8_t)persist_read_int(key);
+  }
+}
+
+// Move the old keys into the blob; returns false if there were none
+static bool prv_migrate(SettingsBlob *blob) {
+  if (!persist_exists(PERSIST_KEY_BG_COLOR)) return false;
+  
+  prv_migrate_byte(&blob->bg_color, PERSIST_KEY_BG_COLOR);
+  prv_migrate_byte(&blob->fg_color, PERSIST_KEY_FG_COLOR);
+  prv_migrate_byte(&blob->secondary_color, PERSIST_KEY_SECONDARY_COLOR);
+  if (persist_exists(PERSIST_KEY_STEP_GOAL)) {
+    blob->step_goal = (uint16_t)persist_read_int(PERSIST_KEY_STEP_GOAL);
+  }
+  prv_migrate_byte(&blob->date_left, PERSIST_KEY_DATE_LEFT);
+  prv_migrate_byte(&blob->date_right, PERSIST_KEY_DATE_RIGHT);
+  prv_migrate_byte(&blob->load_animation, PERSIST_KEY_LOAD_ANIMATION);
+  prv_migrate_flag(blob, PERSIST_KEY_SHOW_STEPS, SETTINGS_FLAG_SHOW_STEPS);
+  prv_migrate_flag(blob, PERSIST_KEY_SHOW_BATTERY, SETTINGS_FLAG_SHOW_BATTERY);
+  prv_migrate_flag(blob, PERSIST_KEY_SHOW_DATE, SETTINGS_FLAG_SHOW_DATE);
+  prv_migrate_flag(blob, PERSIST_KEY_USE_24H, SETTINGS_FLAG_USE_24H);
+  prv_migrate_flag(blob, PERSIST_KEY_SHOW_WEATHER, SETTINGS_FLAG_SHOW_WEATHER);
+  prv_migrate_flag(blob, PERSIST_KEY_WEATHER_UNIT, SETTINGS_FLAG_FAHRENHEIT);
+  prv_migrate_flag(blob, PERSIST_KEY_SHOW_CORNERS, SETTINGS_FLAG_SHOW_CORNERS);
+  
+  prv_write(blob);
+  for (uint32_t key = PERSIST_KEY_BG_COLOR; key <= PERSIST_KEY_SHOW_CORNERS; key++) {
+    persist_delete(key);
+  }
+  return true;
+}
+
+bool settings_decode(SettingsBlob *blob, const uint8_t *data, size_t size) {
+  if (size < 1 || data[0] > SETTINGS_VERSION) return false;
+  memcpy(blob, data, size < sizeof(*blob) ? size : sizeof(*blob));
+  blob->version = SETTINGS_VERSION;
+  return true;
+}
+
+bool settings_load(SettingsBlob *blob) {
+  blob->version = SETTINGS_VERSION;
+  if (!persist_exists(PERSIST_KEY_SETTINGS)) {
+    return prv_migrate(blob);
+  }
+  
+  uint8_t data[sizeof(SettingsBlob)];
+  int size = persist_read_data(PERSIST_KEY_SETTINGS, data, sizeof(data));
+  if (size < 0 || !settings_decode(blob, data, (size_t)size)) return false;
+  
+  s_stored = *blob;
+  s_stored_valid = (size == sizeof(data));
+  return true;
+}
+
+static void prv_commit(void *data) {
+  PROFILE_WAKEUP();
+  s_commit_timer = NULL;
+  prv_write(&s_pending);
+}
+
+void settings_save(const SettingsBlob *blob) {
+  s_pending = *blob;
+  s_pending.version = SETTINGS_VERSION;
+  
+  // Back to what is stored: drop any queued write
+  if (s_stored_valid && memcmp(&s_pending, &s_stored, sizeof(s_pending)) == 0) {
+    if (s_commit_timer) {
+      app_timer_cancel(s_commit_timer);
+      s_commit_timer = NULL;
+    }
+    return;
+  }
+  
+  if (s_commit_timer) {
+    app_timer_reschedule(s_commit_timer, SETTINGS_COMMIT_MS);
+  } else {
+    s_commit_timer = app_timer_register(SETTINGS_COMMIT_MS, prv_commit, NULL);
+  }
+}
+
+void settings_flush(void) {
+  if (!s_commit_timer) return;
+  app_timer_cancel(s_commit_timer);
+  s_commit_timer = NULL;
+  prv_write(&s_pending);
+}
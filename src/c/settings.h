@@ -0,0 +1,46 @@
+#pragma once
+#include <pebble.h>
+
+// All user settings, stored as one blob under PERSIST_KEY_SETTINGS and sent
+// by the phone in the same layout (encodeSettings in src/pkjs/index.js).
+// Only append fields; bump SETTINGS_VERSION if an existing field changes
+// meaning.
+#define SETTINGS_VERSION 1
+
+#define SETTINGS_FLAG_SHOW_STEPS (1 << 0)
+#define SETTINGS_FLAG_SHOW_BATTERY (1 << 1)
+#define SETTINGS_FLAG_SHOW_DATE (1 << 2)
+#define SETTINGS_FLAG_USE_24H (1 << 3)
+#define SETTINGS_FLAG_SHOW_WEATHER (1 << 4)
+#define SETTINGS_FLAG_FAHRENHEIT (1 << 5)
+#define SETTINGS_FLAG_SHOW_CORNERS (1 << 6)
+#define SETTINGS_FLAG_SHOW_SECONDS (1 << 7)
+
+typedef struct __attribute__((__packed__)) {
+  uint8_t version;
+  uint8_t bg_color;         // GColor8 argb
+  uint8_t fg_color;
+  uint8_t secondary_color;
+  uint16_t step_goal;
+  uint8_t load_animation;
+  uint8_t date_left;
+  uint8_t date_right;
+  uint8_t flags;            // SETTINGS_FLAG_*
+  uint8_t step_display;     // 0=Goal bar, 1=Hourly history
+} SettingsBlob;
+
+// Load the stored settings over the defaults in blob with a single read,
+// migrating the old one-key-per-setting layout on first run. Returns false
+// (blob untouched) if nothing is stored.
+bool settings_load(SettingsBlob *blob);
+
+// Decode settings bytes over the values in blob. Older, shorter versions
+// leave the later fields as they were; returns false for unknown versions.
+bool settings_decode(SettingsBlob *blob, const uint8_t *data, size_t size);
+
+// Queue blob for saving. Bursts of calls are merged into one write after
+// SETTINGS_COMMIT_MS, and nothing is written if it matches what is stored.
+void settings_save(const SettingsBlob *blob);
+
+// Write a queued save now (call before the app exits)
+void settings_flush(void);
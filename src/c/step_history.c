@@ -0,0 +1,69 @@
+#include "step_history.h"
+#include <string.h>
+
+// Settings are stored under key 20
+#define PERSIST_KEY_STEP_HISTORY 21
+
+#define SECONDS_PER_HOUR 3600
+#define MINUTES_PER_HOUR 60
+
+void step_history_load(StepHistory *history) {
+  memset(history, 0, sizeof(*history));
+  StepHistory stored;
+  if (persist_read_data(PERSIST_KEY_STEP_HISTORY, &stored, sizeof(stored)) == (int)sizeof(stored)) {
+    *history = stored;
+  }
+}
+
+// Sum one hour of minute records in a single request. The firmware stores
+// minutes with a delay, so an hour counts as read once the records reach its
+// end, or once another hour has passed (the watch may have been off).
+static bool prv_read_hour(HealthMinuteData *minutes, time_t start, time_t now, uint8_t *units) {
+  time_t end = start + SECONDS_PER_HOUR;
+  time_t time_start = start;
+  time_t time_end = end;
+  uint32_t count = health_service_get_minute_history(minutes, MINUTES_PER_HOUR, &time_start, &time_end);
+  if (time_end < end && now < end + SECONDS_PER_HOUR) return false;
+  
+  uint32_t steps = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (!minutes[i].is_invalid) steps += minutes[i].steps;
+  }
+  steps = (steps + STEP_HISTORY_UNIT - 1) / STEP_HISTORY_UNIT;
+  *units = (uint8_t)(steps < 255 ? steps : 255);
+  return true;
+}
+
+bool step_history_update(StepHistory *history, time_t now) {
+  time_t today = time_start_of_today();
+  bool changed = false;
+  if (history->day != (uint32_t)today) {
+    memset(history->hours, 0, sizeof(history->hours));
+    history->day = (uint32_t)today;
+    history->read_hours = 0;
+    changed = true;
+  }
+  
+  int complete = step_history_hour(history, now);
+  if (history->read_hours < complete) {
+    HealthMinuteData *minutes = malloc(MINUTES_PER_HOUR * sizeof(HealthMinuteData));
+    while (minutes && history->read_hours < complete) {
+      time_t start = today + history->read_hours * SECONDS_PER_HOUR;
+      if (!prv_read_hour(minutes, start, now, &history->hours[history->read_hours])) break;
+      history->read_hours++;
+      changed = true;
+    }
+    free(minutes);
+  }
+  
+  if (changed) {
+    persist_write_data(PERSIST_KEY_STEP_HISTORY, history, sizeof(*history));
+  }
+  return changed;
+}
+
+int step_history_hour(const StepHistory *history, time_t now) {
+  if (now < (time_t)history->day) return 0;
+  int hour = (int)((now - (time_t)history->day) / SECONDS_PER_HOUR);
+  return hour < STEP_HISTORY_HOURS ? hour : STEP_HISTORY_HOURS - 1;
+}
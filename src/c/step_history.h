@@ -0,0 +1,26 @@
+#pragma once
+#include <pebble.h>
+
+// Today's steps per hour, for the step history sparkline. The hours are read
+// from the minute history in one batched pass per hour instead of polling the
+// day's total, and are persisted so a restart only reads the hours it missed.
+#define STEP_HISTORY_HOURS 24
+// Steps per stored unit; an hour saturates at 255 units
+#define STEP_HISTORY_UNIT 50
+
+typedef struct __attribute__((__packed__)) {
+  uint8_t hours[STEP_HISTORY_HOURS];  // Ring of one slot per hour of the day,
+                                      // in STEP_HISTORY_UNIT steps
+  uint32_t day;                       // Start of the day the slots are from
+  uint8_t read_hours;                 // Complete hours of that day read so far
+} StepHistory;
+
+// Restore the persisted history (empty if there is none)
+void step_history_load(StepHistory *history);
+
+// Read the complete hours of today not read yet and persist the result.
+// Starts over on a new day; returns true if any hour changed.
+bool step_history_update(StepHistory *history, time_t now);
+
+// Hour of the day `now` falls in, relative to the history's day
+int step_history_hour(const StepHistory *history, time_t now);
@@ -0,0 +1,67 @@
+#pragma once
+#include <pebble.h>
+
+// Q16.16 fixed point. The Pebble CPUs have no FPU, so float math is emulated
+// in software; animation code works in fixed_t instead.
+typedef int32_t fixed_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE ((fixed_t)1 << FIXED_SHIFT)
+// Constant conversion (only use with compile-time constants)
+#define FIXED(value) ((fixed_t)((value) * FIXED_ONE))
+
+static inline fixed_t fixed_from_int(int value) {
+  return (fixed_t)value * FIXED_ONE;
+}
+
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b) {
+  return (fixed_t)(((int64_t)a * b) >> FIXED_SHIFT);
+}
+
+// Round toward negative infinity
+static inline int fixed_floor(fixed_t value) {
+  return value >> FIXED_SHIFT;
+}
+
+// Elapsed time over a fixed duration
+typedef struct {
+  uint16_t elapsed_ms;
+  uint16_t duration_ms;
+} Timeline;
+
+static inline void timeline_start(Timeline *timeline, uint16_t duration_ms) {
+  timeline->elapsed_ms = 0;
+  timeline->duration_ms = duration_ms;
+}
+
+// A finished timeline reports full progress
+static inline void timeline_finish(Timeline *timeline) {
+  timeline->elapsed_ms = timeline->duration_ms;
+}
+
+static inline void timeline_advance(Timeline *timeline, uint16_t ms) {
+  uint32_t elapsed = (uint32_t)timeline->elapsed_ms + ms;
+  timeline->elapsed_ms = elapsed < timeline->duration_ms ? (uint16_t)elapsed : timeline->duration_ms;
+}
+
+static inline bool timeline_done(const Timeline *timeline) {
+  return timeline->elapsed_ms >= timeline->duration_ms;
+}
+
+// 0 to FIXED_ONE
+static inline fixed_t timeline_progress(const Timeline *timeline) {
+  if (timeline_done(timeline)) return FIXED_ONE;
+  return (fixed_t)(((uint32_t)timeline->elapsed_ms << FIXED_SHIFT) / timeline->duration_ms);
+}
+
+// Progress through the [start, end] part of a progress value, clamped to 0..FIXED_ONE
+static inline fixed_t timeline_segment(fixed_t progress, fixed_t start, fixed_t end) {
+  if (progress <= start) return 0;
+  if (progress >= end) return FIXED_ONE;
+  return (fixed_t)(((int64_t)(progress - start) << FIXED_SHIFT) / (end - start));
+}
+
+// Smoothstep over 0..FIXED_ONE: t^2 * (3 - 2t)
+static inline fixed_t ease_in_out(fixed_t t) {
+  return fixed_mul(fixed_mul(t, t), 3 * FIXED_ONE - 2 * t);
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <pebble.h>
+
+// Wall clock in ms (wraps, only differences are used)
+static inline uint32_t wall_clock_ms(void) {
+  time_t seconds;
+  uint16_t ms;
+  time_ms(&seconds, &ms);
+  return (uint32_t)seconds * 1000 + ms;
+}
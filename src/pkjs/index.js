@@ -1,10 +1,139 @@
 // GridSpace Configuration
 var Clay = require('@rebble/clay');
 var clayConfig = require('./config.json');
-var clay = new Clay(clayConfig);
+// Clay only builds the page and parses its response: its own
+// webviewclosed handler would send the whole settings dictionary, which
+// does not fit the watch inbox. Settings go out as one byte array below.
+var clay = new Clay(clayConfig, null, { autoHandleEvents: false });
+
+// AppMessage outbox: one message in flight at a time. Values queued
+// meanwhile are merged into the next message, a newer value for a key
+// replacing the older one; NACKed messages are retried with jittered
+// backoff. Everything queued at once must fit the watch inbox (32 bytes
+// on aplite: the settings array plus a temperature just fit).
+var OUTBOX_RETRY_MS = 500;
+var OUTBOX_MAX_ATTEMPTS = 6;
+
+var outboxPending = {};   // key -> {value, onSent} waiting to be sent
+var outboxInFlight = null;
+var outboxAttempts = 0;
+var outboxTimer = null;
+
+function outboxQueue(key, value, onSent) {
+  outboxPending[key] = { value: value, onSent: onSent };
+  // Wait for the current turn so values queued together go in one message
+  if (!outboxTimer) {
+    outboxSchedule(0);
+  }
+}
+
+function outboxSchedule(delayMs) {
+  if (outboxTimer) {
+    clearTimeout(outboxTimer);
+  }
+  outboxTimer = setTimeout(function() {
+    outboxTimer = null;
+    outboxFlush();
+  }, delayMs);
+}
+
+function outboxHas(key) {
+  return key in outboxPending || (outboxInFlight !== null && key in outboxInFlight);
+}
+
+function outboxFlush() {
+  if (outboxInFlight || outboxTimer || Object.keys(outboxPending).length === 0) {
+    return;
+  }
+  
+  outboxInFlight = outboxPending;
+  outboxPending = {};
+  var message = {};
+  Object.keys(outboxInFlight).forEach(function(key) {
+    message[key] = outboxInFlight[key].value;
+  });
+  
+  Pebble.sendAppMessage(message, outboxAcked, outboxNacked);
+}
+
+function outboxAcked() {
+  var sent = outboxInFlight;
+  outboxInFlight = null;
+  outboxAttempts = 0;
+  Object.keys(sent).forEach(function(key) {
+    if (sent[key].onSent) {
+      sent[key].onSent(sent[key].value);
+    }
+  });
+  outboxFlush();
+}
+
+function outboxNacked(e) {
+  var failed = outboxInFlight;
+  outboxInFlight = null;
+  outboxAttempts++;
+  if (outboxAttempts >= OUTBOX_MAX_ATTEMPTS) {
+    console.log('Dropping message after ' + outboxAttempts + ' attempts: ' + JSON.stringify(Object.keys(failed)));
+    outboxAttempts = 0;
+    outboxFlush();
+    return;
+  }
+  
+  // Requeue what was not superseded while the message was in flight
+  Object.keys(failed).forEach(function(key) {
+    if (!(key in outboxPending)) {
+      outboxPending[key] = failed[key];
+    }
+  });
+  
+  outboxSchedule(OUTBOX_RETRY_MS * Math.pow(2, outboxAttempts - 1) * (0.5 + Math.random()));
+}
 
 // Weather functionality
-var lastWeatherData = null; // Store last weather data
+var WEATHER_REFRESH_MS = 30 * 60 * 1000;   // Cached temperature counts as fresh for this long
+var WEATHER_RETRY_MS = 60 * 1000;          // First retry after a failure, doubling each time
+var LOCATION_MOVE_KM = 5;                  // Refetch early once the device moved this far
+var LOCATION_MAX_AGE_MS = 60 * 60 * 1000;  // Accept a position fix up to this old
+var WEATHER_CACHE_KEY = 'weather';
+var SHOW_WEATHER_KEY = 'showWeather';
+
+var weatherTimer = null;
+var weatherFailures = 0;
+var sentTemperature = null;  // Last temperature the watch got this session
+
+// {lat, lon, tempCelsius, fetchedAt} of the last successful fetch
+function loadWeatherCache() {
+  try {
+    return JSON.parse(localStorage.getItem(WEATHER_CACHE_KEY)) || null;
+  } catch (e) {
+    return null;
+  }
+}
+
+function saveWeatherCache(cache) {
+  localStorage.setItem(WEATHER_CACHE_KEY, JSON.stringify(cache));
+}
+
+function weatherEnabled() {
+  var stored = localStorage.getItem(SHOW_WEATHER_KEY);
+  if (stored !== null) {
+    return stored === 'true';
+  }
+  // Not configured since this was added: use what Clay saved
+  try {
+    return settingEnabled(JSON.parse(localStorage.getItem('clay-settings')) || {}, 'SHOW_WEATHER');
+  } catch (e) {
+    return false;
+  }
+}
+
+// Equirectangular approximation, plenty for a few kilometres
+function distanceKm(a, b) {
+  var rad = Math.PI / 180;
+  var x = (b.lon - a.lon) * rad * Math.cos((a.lat + b.lat) / 2 * rad);
+  var y = (b.lat - a.lat) * rad;
+  return Math.sqrt(x * x + y * y) * 6371;
+}
 
 function getLocation(successCallback, errorCallback) {
   navigator.geolocation.getCurrentPosition(
@@ -17,7 +146,8 @@ function getLocation(successCallback, errorCallback) {
     function(error) {
       errorCallback(error);
     },
-    { timeout: 15000, maximumAge: 300000 } // 5 minute cache
+    // A coarse, possibly cached fix is enough for the temperature
+    { enableHighAccuracy: false, timeout: 15000, maximumAge: LOCATION_MAX_AGE_MS }
   );
 }
 
@@ -33,14 +163,8 @@ function fetchWeather(lat, lon, successCallback, errorCallback) {
         try {
           var data = JSON.parse(xhr.responseText);
           if (data.current) {
-            var tempCelsius = Math.round(data.current.temperature_2m);
-            // Store weather data for caching
-            lastWeatherData = {
-              tempCelsius: tempCelsius
-            };
-            
             successCallback({
-              temperature: tempCelsius, // Always send Celsius to C code
+              temperature: Math.round(data.current.temperature_2m) // Always send Celsius to C code
             });
           } else {
             errorCallback('Invalid weather data received');
@@ -67,54 +191,161 @@ function fetchWeather(lat, lon, successCallback, errorCallback) {
   xhr.send();
 }
 
+// Send the temperature only if the watch does not have it already
+function sendTemperature(tempCelsius) {
+  if (tempCelsius === sentTemperature && !outboxHas('WEATHER_TEMPERATURE')) {
+    return;
+  }
+  
+  outboxQueue('WEATHER_TEMPERATURE', tempCelsius, function(value) {
+    sentTemperature = value;
+  });
+}
+
+function scheduleWeather(delayMs) {
+  if (weatherTimer) {
+    clearTimeout(weatherTimer);
+  }
+  weatherTimer = setTimeout(function() {
+    weatherTimer = null;
+    updateWeather();
+  }, delayMs);
+}
+
+function stopWeather() {
+  if (weatherTimer) {
+    clearTimeout(weatherTimer);
+    weatherTimer = null;
+  }
+}
+
+// Keep the last value on the watch and retry with exponential backoff
+function weatherFailed(error) {
+  console.log('Weather update failed: ' + error);
+  var delay = Math.min(WEATHER_RETRY_MS * Math.pow(2, weatherFailures), WEATHER_REFRESH_MS);
+  weatherFailures++;
+  scheduleWeather(delay);
+}
+
 function updateWeather() {
-  console.log('Fetching weather data in Celsius...');
+  if (!weatherEnabled()) {
+    stopWeather();
+    return;
+  }
+  
+  // Stale-while-revalidate: show the cached value right away
+  var cache = loadWeatherCache();
+  if (cache) {
+    sendTemperature(cache.tempCelsius);
+  }
   
   getLocation(
     function(location) {
-      console.log('Got location: ' + location.lat + ', ' + location.lon);
+      var age = cache ? Date.now() - cache.fetchedAt : Infinity;
+      var moved = cache ? distanceKm(cache, location) > LOCATION_MOVE_KM : true;
+      if (!moved && age < WEATHER_REFRESH_MS) {
+        scheduleWeather(WEATHER_REFRESH_MS - age);
+        return;
+      }
       
+      console.log('Fetching weather data in Celsius...');
       fetchWeather(location.lat, location.lon,
         function(weather) {
           console.log('Weather: ' + weather.temperature + '°C');
-          
-          // Send weather data to watch (always in Celsius)
-          Pebble.sendAppMessage({
-            'WEATHER_TEMPERATURE': weather.temperature
-          }, 
-          function() {
-            console.log('Weather data sent successfully');
-          },
-          function(error) {
-            console.log('Error sending weather: ' + error);
+          weatherFailures = 0;
+          saveWeatherCache({
+            lat: location.lat,
+            lon: location.lon,
+            tempCelsius: weather.temperature,
+            fetchedAt: Date.now()
           });
+          sendTemperature(weather.temperature);
+          scheduleWeather(WEATHER_REFRESH_MS);
         },
-        function(error) {
-          console.log('Weather fetch error: ' + error);
-          // Send fallback data
-          Pebble.sendAppMessage({
-            'WEATHER_TEMPERATURE': 0,
-          });
-        }
+        weatherFailed
       );
     },
     function(error) {
-      console.log('Location error: ' + error);
-      // Send fallback data
-      Pebble.sendAppMessage({
-        'WEATHER_TEMPERATURE': 0,
-      });
+      weatherFailed('Location error: ' + (error && error.message ? error.message : error));
     }
   );
 }
 
-// Update weather on app start and every 30 minutes
+// Update weather on app start, then when the cached value goes stale
 Pebble.addEventListener('ready', function() {
   console.log('PebbleKit JS ready!');
   updateWeather();
+});
+
+// Settings travel to the watch as one byte array laid out like the watch's
+// SettingsBlob (src/c/settings.h): version byte first, then the fields,
+// multi-byte values little-endian. Only append fields; bump the version if
+// an existing field changes meaning.
+var SETTINGS_VERSION = 1;
+var SETTINGS_FLAGS = {
+  SHOW_STEPS: 1 << 0,
+  SHOW_BATTERY: 1 << 1,
+  SHOW_DATE: 1 << 2,
+  USE_24_HOUR: 1 << 3,
+  SHOW_WEATHER: 1 << 4,
+  SHOW_CORNERS: 1 << 6,
+  SHOW_SECONDS: 1 << 7
+};
+var SETTINGS_FLAG_FAHRENHEIT = 1 << 5;
+
+// Clay values may be wrapped as {value: ...}
+function settingValue(settings, key, fallback) {
+  var value = settings[key];
+  if (value && typeof value === 'object' && 'value' in value) {
+    value = value.value;
+  }
+  return (value === undefined || value === null || value === '') ? fallback : value;
+}
+
+function settingEnabled(settings, key) {
+  var value = settingValue(settings, key, false);
+  return value === true || value === 1 || value === '1';
+}
+
+// 0xRRGGBB to the watch's 8-bit color (same as GColorFromHEX)
+function colorToGColor8(color) {
+  var hex = typeof color === 'string' ? parseInt(color.replace('#', ''), 16) : color;
+  return 0xC0 | (((hex >> 22) & 3) << 4) | (((hex >> 14) & 3) << 2) | ((hex >> 6) & 3);
+}
+
+function clamp(value, min, max) {
+  return Math.min(Math.max(value, min), max);
+}
+
+function encodeSettings(settings) {
+  var stepGoal = clamp(parseInt(settingValue(settings, 'STEP_GOAL', 8000), 10) || 8000, 1000, 50000);
+  var flags = 0;
+  Object.keys(SETTINGS_FLAGS).forEach(function(key) {
+    if (settingEnabled(settings, key)) {
+      flags |= SETTINGS_FLAGS[key];
+    }
+  });
+  if (settingValue(settings, 'WEATHER_UNIT', 'C') === 'F') {
+    flags |= SETTINGS_FLAG_FAHRENHEIT;
+  }
   
-  // Update weather every 30 minutes
-  setInterval(updateWeather, 30 * 60 * 1000);
+  return [
+    SETTINGS_VERSION,
+    colorToGColor8(settingValue(settings, 'BACKGROUND_COLOR', 0x000000)),
+    colorToGColor8(settingValue(settings, 'FOREGROUND_COLOR', 0xFFFFFF)),
+    colorToGColor8(settingValue(settings, 'SECONDARY_COLOR', 0xAAAAAA)),
+    stepGoal & 0xFF,
+    (stepGoal >> 8) & 0xFF,
+    clamp(parseInt(settingValue(settings, 'LOAD_ANIMATION', 2), 10) || 0, 0, 3),
+    clamp(parseInt(settingValue(settings, 'DATE_LEFT', 3), 10) || 0, 0, 5),
+    clamp(parseInt(settingValue(settings, 'DATE_RIGHT', 4), 10) || 0, 0, 5),
+    flags,
+    clamp(parseInt(settingValue(settings, 'STEP_DISPLAY', 0), 10) || 0, 0, 1)
+  ];
+}
+
+Pebble.addEventListener('showConfiguration', function() {
+  Pebble.openURL(clay.generateUrl());
 });
 
 // Listen for Clay configuration changes
@@ -123,24 +354,22 @@ Pebble.addEventListener('webviewclosed', function(e) {
     return;
   }
   
-  var claySettings = clay.getSettings(e.response);
+  // Before getSettings, which stores the new values where weatherEnabled
+  // falls back to
+  var wasShown = weatherEnabled();
+  var claySettings = clay.getSettings(e.response, false);
   console.log('Configuration received: ' + JSON.stringify(claySettings));
   
-  // Send cached weather data if available (C code will handle conversion)
-  if (lastWeatherData) {
-    console.log('Sending cached weather data to watch');
-    Pebble.sendAppMessage({
-      'WEATHER_TEMPERATURE': lastWeatherData.tempCelsius,
-    });
+  // Fetch weather only while it is shown
+  var showWeather = settingEnabled(claySettings, 'SHOW_WEATHER');
+  localStorage.setItem(SHOW_WEATHER_KEY, showWeather ? 'true' : 'false');
+  if (showWeather && !wasShown) {
+    weatherFailures = 0;
+    updateWeather();
+  } else if (!showWeather) {
+    stopWeather();
   }
   
-  // Send all configuration to watch
-  Pebble.sendAppMessage(claySettings,
-    function(e) {
-      console.log('Configuration sent successfully');
-    },
-    function(e) {
-      console.log('Failed to send configuration: ' + JSON.stringify(e));
-    }
-  );
-});
\ No newline at end of file
+  // Send all configuration to watch as one packed byte array
+  outboxQueue('SETTINGS', encodeSettings(claySettings));
+});